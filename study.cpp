@@ -5,6 +5,41 @@
 // #include <typeinfo>
 // #include <vector>
 // #include <algorithm>
+// #include <chrono>
+// #include <atomic>
+// #include <thread>
+// #include <mutex>
+// #include <numeric>
+// #include <cstring>
+// #include <memory>
+// #include <charconv>
+// #include <unordered_map>
+// #include <deque>
+// #include <map>
+// #include <string_view>
+// #include <shared_mutex>
+// #include <memory_resource>
+// #include <immintrin.h>
+// #include <future>
+// #include <condition_variable>
+// #include <functional>
+// #include <climits>
+// #include <unistd.h>
+// #include <sys/syscall.h>
+// #include <linux/futex.h>
+// #include <sys/mman.h>
+// #include <sys/stat.h>
+// #include <fcntl.h>
+// #include <random>
+// #include <sys/inotify.h>
+// #include <poll.h>
+// #include <array>
+// #include <tuple>
+// #include <cmath>
+// #include <limits>
+// #include <type_traits>
+// #include <variant>
+// #include <utility>
 
 using namespace std;
 
@@ -348,6 +383,170 @@ using namespace std;
 // typedef int ARR[]; // ARRは完全になることはできない
 
 
+/**
+ * 不完全型のままインライン領域にpimplを持たせたい
+ * [basic.types],[basic.align],[ptr.launder]
+ */
+// // 不完全型のオブジェクトは定義できないため，pimplでは通常unique_ptr<Impl>のようにヒープに確保する
+// // しかしオブジェクト1つにつき，動的確保が1回とポインタを辿る処理が1回余計にかかる
+// // Implのサイズとアライメントの上限をテンプレート引数で与えれば，所有者の中に領域を確保できる
+// // 領域は alignas を指定した unsigned char の配列で用意し，配置newでImplを構築する
+// // メンバ関数の本体は使用されるまで実体化されないので，
+// // Implが完全型になる翻訳単位(.cpp)で特殊メンバ関数を定義すれば，そこで初めてサイズとアライメントが検査される
+// template<typename T, size_t Size, size_t Align=alignof(max_align_t)>
+// class fast_pimpl{
+//         alignas(Align) unsigned char m_storage[Size];
+//
+//         // Tが完全型になっている場所でしか呼べない
+//         static constexpr void check()
+//         {
+//                 static_assert(sizeof(T)<=Size, "Sizeが小さすぎる");
+//                 static_assert(Align%alignof(T)==0, "Alignが合わない");
+//         }
+// public:
+//         template<typename ... Args>
+//         explicit fast_pimpl(in_place_t, Args&& ... args)
+//         {
+//                 check();
+//                 ::new(static_cast<void*>(m_storage)) T{forward<Args>(args)...};
+//         }
+//
+//         fast_pimpl(fast_pimpl const& other):fast_pimpl(in_place, *other){}
+//         fast_pimpl(fast_pimpl&& other) noexcept(is_nothrow_move_constructible_v<T>):fast_pimpl(in_place, move(*other)){}
+//
+//         fast_pimpl& operator=(fast_pimpl const& other)
+//         {
+//                 **this=*other;
+//                 return *this;
+//         }
+//
+//         fast_pimpl& operator=(fast_pimpl&& other) noexcept(is_nothrow_move_assignable_v<T>)
+//         {
+//                 **this=move(*other);
+//                 return *this;
+//         }
+//
+//         ~fast_pimpl()
+//         {
+//                 check();
+//                 (**this).~T();
+//         }
+//
+//         T& operator*() noexcept
+//         {
+//                 return *launder(reinterpret_cast<T*>(m_storage));
+//         }
+//
+//         T const& operator*() const noexcept
+//         {
+//                 return *launder(reinterpret_cast<T const*>(m_storage));
+//         }
+//
+//         T* operator->() noexcept
+//         {
+//                 return &**this;
+//         }
+//
+//         T const* operator->() const noexcept
+//         {
+//                 return &**this;
+//         }
+// };
+//
+// // ---- widget.h ----
+// // ImplはWidgetの中では不完全型のままである
+// // 特殊メンバ関数は宣言だけにして，定義はwidget.cppに置く
+// class Widget{
+//         struct Impl;
+//         fast_pimpl<Impl, 40, 8> m_impl;
+// public:
+//         explicit Widget(int a);
+//         Widget(Widget const&);
+//         Widget(Widget&&) noexcept;
+//         Widget& operator=(Widget const&);
+//         Widget& operator=(Widget&&) noexcept;
+//         ~Widget();
+//
+//         int value() const;
+// };
+//
+// // ---- widget.cpp ----
+// struct Widget::Impl{
+//         int a;
+//         string s;
+// };
+//
+// Widget::Widget(int a):m_impl{in_place, a, "hoge"}{}
+// Widget::Widget(Widget const&)=default;
+// Widget::Widget(Widget&&) noexcept=default;
+// Widget& Widget::operator=(Widget const&)=default;
+// Widget& Widget::operator=(Widget&&) noexcept=default;
+// Widget::~Widget()=default;
+//
+// int Widget::value() const
+// {
+//         return m_impl->a;
+// }
+//
+// // 比較用のunique_ptrを使った通常のpimpl
+// class WidgetU{
+//         struct Impl;
+//         unique_ptr<Impl> m_impl;
+// public:
+//         explicit WidgetU(int a);
+//         WidgetU(WidgetU&&) noexcept;
+//         ~WidgetU();
+//
+//         int value() const;
+// };
+//
+// struct WidgetU::Impl{
+//         int a;
+//         string s;
+// };
+//
+// WidgetU::WidgetU(int a):m_impl{new Impl{a, "hoge"}}{}
+// WidgetU::WidgetU(WidgetU&&) noexcept=default;
+// WidgetU::~WidgetU()=default;
+//
+// int WidgetU::value() const
+// {
+//         return m_impl->a;
+// }
+//
+// // 生成・破棄と，生成済みのオブジェクトへのアクセスの時間を比較する
+// template<typename W>
+// void bench_pimpl(char const* name, int n)
+// {
+//         auto t0=chrono::steady_clock::now();
+//         vector<W> v;
+//         v.reserve(n);
+//         for(int i=0; i<n; ++i){
+//                 v.emplace_back(i);
+//         }
+//
+//         auto t1=chrono::steady_clock::now();
+//         long long sum=0;
+//         for(auto& w: v){
+//                 sum+=w.value();
+//         }
+//
+//         auto t2=chrono::steady_clock::now();
+//         v.clear();
+//         auto t3=chrono::steady_clock::now();
+//
+//         chrono::duration<double, nano> create=t1-t0, access=t2-t1, destroy=t3-t2;
+//         cout << name << ": create " << create.count()/n << " ns, access " << access.count()/n
+//              << " ns, destroy " << destroy.count()/n << " ns (" << sum << ")" << endl;
+// }
+//
+// void bench_pimpl()
+// {
+//         bench_pimpl<WidgetU>("unique_ptr", 1'000'000);
+//         bench_pimpl<Widget>("fast_pimpl", 1'000'000);
+// }
+
+
 /**
  * mutable指定子の使い方を確認したい
  * [dcl.stc]
@@ -367,6 +566,165 @@ using namespace std;
 // };
 
 
+/**
+ * mutableメンバによるメモ化をロックフリーにしたい
+ * [dcl.stc],[intro.races],[atomics.fences]
+ */
+// // constメンバ関数内で計算結果をキャッシュする場合，mutableメンバにキャッシュを持たせるのが定石である
+// // ただし標準ライブラリはconstメンバ関数が複数スレッドから同時に呼ばれても安全であることを前提にしている
+// // そのためmutableメンバを変更する場合は，データ競合が起きないようにしなければならない
+// // mutexで保護すると，読み取りだけのスレッド同士でもロックを取り合うことになる
+// // シーケンスロック(seqlock)を使うと，読み取り側はロックを取らずに済む
+// // ・m_seqが奇数の間は書き込み中である
+// // ・読み取り側はm_seqを前後で読み，偶数かつ同じ値であれば途中で書き込みは無かったことになる
+// // ・読み取りに失敗した場合は待たずに自分で計算するので，読み取り側は待機しない(wait-free)
+// // 値は複数のatomicなワードに分割して格納する，非atomicなオブジェクトを書き込み中に読むとデータ競合(UB)になるため
+// template<typename T>
+// class memo{
+//         static_assert(is_trivially_copyable_v<T>);
+//
+//         static constexpr size_t N=(sizeof(T)+sizeof(uintptr_t)-1)/sizeof(uintptr_t);
+//
+//         atomic<unsigned> m_seq{0};
+//         atomic<bool> m_valid{false};
+//         atomic<uintptr_t> m_words[N]{};
+//
+//         // m_seqをseqからseq+1に変更できたスレッドだけが書き込める
+//         bool try_begin(unsigned seq)
+//         {
+//                 return seq%2==0 && m_seq.compare_exchange_strong(seq, seq+1, memory_order_acquire);
+//         }
+//
+//         void end(unsigned seq)
+//         {
+//                 m_seq.store(seq+2, memory_order_release);
+//         }
+// public:
+//         template<typename F>
+//         T get(F compute)
+//         {
+//                 unsigned s1=m_seq.load(memory_order_acquire);
+//                 uintptr_t buf[N];
+//                 bool valid=m_valid.load(memory_order_relaxed);
+//                 for(size_t i=0; i<N; ++i){
+//                         buf[i]=m_words[i].load(memory_order_relaxed);
+//                 }
+//                 atomic_thread_fence(memory_order_acquire);
+//
+//                 T v;
+//                 if(s1%2==0 && valid && m_seq.load(memory_order_relaxed)==s1){
+//                         memcpy(&v, buf, sizeof(T));
+//                         return v;
+//                 }
+//
+//                 // 計算中にinvalidateされた場合はm_seqが変わっているので，古い値は書き込まれない
+//                 v=compute();
+//                 if(try_begin(s1)){
+//                         atomic_thread_fence(memory_order_release);
+//                         memcpy(buf, &v, sizeof(T));
+//                         for(size_t i=0; i<N; ++i){
+//                                 m_words[i].store(buf[i], memory_order_relaxed);
+//                         }
+//                         m_valid.store(true, memory_order_relaxed);
+//                         end(s1);
+//                 }
+//                 return v;
+//         }
+//
+//         // 元データを変更した後に呼ぶ
+//         void invalidate()
+//         {
+//                 unsigned seq=m_seq.load(memory_order_relaxed);
+//                 while(!try_begin(seq)){
+//                         seq=m_seq.load(memory_order_relaxed);
+//                 }
+//                 m_valid.store(false, memory_order_relaxed);
+//                 end(seq);
+//         }
+// };
+//
+// // 比較用のmutexで保護したキャッシュ
+// template<typename T>
+// class locked_memo{
+//         mutex m_mtx;
+//         bool m_valid=false;
+//         T m_value{};
+// public:
+//         template<typename F>
+//         T get(F compute)
+//         {
+//                 lock_guard<mutex> lock(m_mtx);
+//                 if(!m_valid){
+//                         m_value=compute();
+//                         m_valid=true;
+//                 }
+//                 return m_value;
+//         }
+//
+//         void invalidate()
+//         {
+//                 lock_guard<mutex> lock(m_mtx);
+//                 m_valid=false;
+//         }
+// };
+//
+// // 使い方は上のmutableの例と同じで，constメンバ関数から変更する
+// template<template<typename> class Memo>
+// struct X{
+//         vector<int> m_data;
+//         mutable Memo<long long> m_sum;
+//
+//         long long sum() const
+//         {
+//                 return m_sum.get([&]{ return accumulate(m_data.begin(), m_data.end(), 0LL); });
+//         }
+//
+//         void push(int a)
+//         {
+//                 m_data.push_back(a);
+//                 m_sum.invalidate();
+//         }
+// };
+//
+// // 1から64スレッドで同時にsum()を呼び出した時のスループットを比較する
+// template<template<typename> class Memo>
+// double bench_memo(unsigned threads, int n)
+// {
+//         X<Memo> x;
+//         for(int i=0; i<1000; ++i){
+//                 x.push(i);
+//         }
+//
+//         X<Memo> const& cx=x;
+//         atomic<long long> total{0};
+//         vector<thread> ts;
+//         auto start=chrono::steady_clock::now();
+//         for(unsigned t=0; t<threads; ++t){
+//                 ts.emplace_back([&]{
+//                         long long s=0;
+//                         for(int i=0; i<n; ++i){
+//                                 s+=cx.sum();
+//                         }
+//                         total+=s;
+//                 });
+//         }
+//         for(auto& t: ts){
+//                 t.join();
+//         }
+//         chrono::duration<double> d=chrono::steady_clock::now()-start;
+//         return threads*static_cast<double>(n)/d.count()/1e6;
+// }
+//
+// void bench_memo()
+// {
+//         for(unsigned threads=1; threads<=64; threads*=2){
+//                 cout << threads << " threads: "
+//                      << "seqlock " << bench_memo<memo>(threads, 1'000'000) << " Mops/s, "
+//                      << "mutex " << bench_memo<locked_memo>(threads, 1'000'000) << " Mops/s" << endl;
+//         }
+// }
+
+
 /**
  * using宣言でテンプレート識別子が使えないことを確認したい
  */
@@ -626,12 +984,104 @@ using namespace std;
 //         }
 // };
 //
-// Y y1;
-// Y y2=y1; // Y::operator Y()は呼ばれない
-// X& x=y1;
+// Y y; // y0，y1は<cmath>が宣言するベッセル関数と衝突する
+// Y y2=y; // Y::operator Y()は呼ばれない
+// X& x=y;
 // Y y3=x; // オーバーライドしたY::operator Y()が呼ばれる
 
 
+/**
+ * 仮想変換関数をCRTPで静的多態に置き換えたい
+ * [class.conv.fct],[class.copy.elision]
+ */
+// // 上の例ではX::operator Y()が仮想関数のため，Y y3=x は仮想関数呼び出しとなる
+// // その場合Xはvtableへのポインタを持ち，変換の度に間接呼び出しが発生する
+// // CRTP(Curiously Recurring Template Pattern)を使うと，派生クラスの型を基底クラスのテンプレート引数として渡せる
+// // 変換関数の呼び出し先はコンパイル時に決まるので，vtableへのポインタも間接呼び出しも不要になる
+// // また変換関数がprvalueを返す場合，C++17以降は返却値のコピー省略が保証される
+// namespace virt{
+//         struct Y;
+//
+//         struct X{
+//                 virtual operator Y() const=0;
+//         };
+//
+//         struct Y: X{
+//                 int m_v;
+//
+//                 Y(int v=0):m_v{v}{}
+//
+//                 operator Y() const override
+//                 {
+//                         return Y(m_v+1);
+//                 }
+//         };
+// }
+//
+// namespace crtp{
+//         template<typename Derived>
+//         struct X{
+//                 // Derivedはこの時点では不完全型だが，メンバ関数の本体は使用されるまで実体化されないので問題ない
+//                 operator Derived() const
+//                 {
+//                         return static_cast<Derived const&>(*this).convert(); // prvalueなのでコピー省略が保証される
+//                 }
+//         };
+//
+//         struct Y: X<Y>{
+//                 int m_v;
+//
+//                 Y(int v=0):m_v{v}{}
+//                 Y(Y const&)=delete; // コピーもムーブもできなくても変換できる
+//
+//                 Y convert() const
+//                 {
+//                         return Y(m_v+1);
+//                 }
+//         };
+// }
+//
+// // CRTP版はvtableへのポインタを持たない
+// static_assert(sizeof(virt::Y)>sizeof(int));
+// static_assert(sizeof(crtp::Y)==sizeof(int));
+//
+// // 利用側の書き方は変わらない(y0，y1は<cmath>が宣言するベッセル関数と衝突するので使わない)
+// crtp::Y y;
+// crtp::X<crtp::Y>& x=y;
+// crtp::Y y3=x; // crtp::X<crtp::Y>::operator crtp::Y()が呼ばれ，直接y3が初期化される
+//
+// // 変換1回あたりのコストを比較する
+// // volatileなポインタを経由することで，コンパイラによる仮想関数呼び出しの最適化(devirtualization)を防ぐ
+// template<typename F>
+// double measure(F f, int n)
+// {
+//         auto start=chrono::steady_clock::now();
+//         for(int i=0; i<n; ++i){
+//                 f();
+//         }
+//         chrono::duration<double, nano> d=chrono::steady_clock::now()-start;
+//         return d.count()/n;
+// }
+//
+// void bench_conversion()
+// {
+//         int const n=100'000'000;
+//         long long sum=0;
+//
+//         virt::Y vy;
+//         virt::X* volatile vx=&vy;
+//         double t1=measure([&]{ virt::Y r=*vx; sum+=r.m_v; }, n);
+//
+//         crtp::Y sy;
+//         crtp::X<crtp::Y>* volatile sx=&sy;
+//         double t2=measure([&]{ crtp::Y r=*sx; sum+=r.m_v; }, n);
+//
+//         cout << "virtual: " << t1 << " ns/conv" << '\n';
+//         cout << "crtp:    " << t2 << " ns/conv" << '\n';
+//         cout << sum << endl;
+// }
+
+
 /**
  * ネストクラスの仕様を確認したい
  */
@@ -685,6 +1135,239 @@ using namespace std;
 // };
 
 
+/**
+ * ネストクラスのフックで侵入型(intrusive)コンテナを作りたい
+ * [class.nest],[expr.static.cast],[class.derived]
+ */
+// // 上の例ではYがX&を持つことで外側のオブジェクトに到達していたが，参照1つ分のメモリと間接参照が必要になる
+// // コンテナのネストクラスとしてリンク用のフックを定義し，要素がそれを基底クラスとして持つようにすると，
+// // フックから要素へはstatic_castでダウンキャストするだけで到達できる
+// // 基底クラスの部分オブジェクトの位置はコンパイル時に決まるので，この変換は定数の加減算(多くの場合0)にしかならない
+// // リンクは要素自身が持つので，要素の挿入でノードを動的確保することは無い
+// // 同じ要素を複数のコンテナに入れる場合は，タグ型でフックの型を区別する
+// template<typename T, typename Tag=void>
+// class ilist{
+// public:
+//         struct hook{
+//                 hook* prev=nullptr;
+//                 hook* next=nullptr;
+//
+//                 hook()=default;
+//                 hook(hook const&){} // リンクの状態はコピーしない
+//                 hook& operator=(hook const&){ return *this; }
+//
+//                 bool linked() const
+//                 {
+//                         return next!=nullptr;
+//                 }
+//         };
+//
+//         class iterator{
+//                 hook* m_p;
+//         public:
+//                 explicit iterator(hook* p):m_p{p}{}
+//                 T& operator*() const { return owner(*m_p); }
+//                 iterator& operator++(){ m_p=m_p->next; return *this; }
+//                 bool operator!=(iterator const& other) const { return m_p!=other.m_p; }
+//         };
+// private:
+//         hook m_head; // 番兵，要素ではないのでownerで変換してはいけない
+//         size_t m_size=0;
+//
+//         static T& owner(hook& h)
+//         {
+//                 return static_cast<T&>(h);
+//         }
+//
+//         void link(hook& pos, hook& h)
+//         {
+//                 h.next=&pos;
+//                 h.prev=pos.prev;
+//                 pos.prev->next=&h;
+//                 pos.prev=&h;
+//                 ++m_size;
+//         }
+// public:
+//         ilist()
+//         {
+//                 m_head.prev=m_head.next=&m_head;
+//         }
+//
+//         ilist(ilist const&)=delete;
+//         ilist& operator=(ilist const&)=delete;
+//
+//         void push_front(T& x){ link(*m_head.next, x); }
+//         void push_back(T& x){ link(m_head, x); }
+//
+//         void erase(T& x)
+//         {
+//                 hook& h=x;
+//                 h.prev->next=h.next;
+//                 h.next->prev=h.prev;
+//                 h.prev=h.next=nullptr;
+//                 --m_size;
+//         }
+//
+//         T& front(){ return owner(*m_head.next); }
+//         T& back(){ return owner(*m_head.prev); }
+//         bool empty() const { return m_size==0; }
+//         size_t size() const { return m_size; }
+//
+//         iterator begin(){ return iterator{m_head.next}; }
+//         iterator end(){ return iterator{&m_head}; }
+// };
+//
+// // バケット配列は構築時にのみ確保し，挿入では確保しない
+// // 要素はキーを返すメンバ関数key()を持つものとする
+// template<typename T, typename Key, typename Tag=void, typename Hash=hash<Key>>
+// class ihash{
+// public:
+//         struct hook{
+//                 hook* next=nullptr;
+//                 size_t hash=0;
+//
+//                 hook()=default;
+//                 hook(hook const&){}
+//                 hook& operator=(hook const&){ return *this; }
+//         };
+// private:
+//         vector<hook*> m_buckets;
+//         size_t m_mask;
+//         size_t m_size=0;
+//
+//         static T& owner(hook& h)
+//         {
+//                 return static_cast<T&>(h);
+//         }
+//
+//         static size_t round_up(size_t n)
+//         {
+//                 size_t r=1;
+//                 while(r<n){
+//                         r*=2;
+//                 }
+//                 return r;
+//         }
+// public:
+//         explicit ihash(size_t bucket_count):m_buckets(round_up(bucket_count)), m_mask{m_buckets.size()-1}{}
+//
+//         T* find(Key const& key)
+//         {
+//                 size_t h=Hash{}(key);
+//                 for(hook* p=m_buckets[h&m_mask]; p; p=p->next){
+//                         if(p->hash==h && owner(*p).key()==key){
+//                                 return &owner(*p);
+//                         }
+//                 }
+//                 return nullptr;
+//         }
+//
+//         void insert(T& x)
+//         {
+//                 hook& h=x;
+//                 h.hash=Hash{}(x.key());
+//                 hook*& bucket=m_buckets[h.hash&m_mask];
+//                 h.next=bucket;
+//                 bucket=&h;
+//                 ++m_size;
+//         }
+//
+//         void erase(T& x)
+//         {
+//                 hook& h=x;
+//                 for(hook** p=&m_buckets[h.hash&m_mask]; *p; p=&(*p)->next){
+//                         if(*p==&h){
+//                                 *p=h.next;
+//                                 h.next=nullptr;
+//                                 --m_size;
+//                                 return;
+//                         }
+//                 }
+//         }
+//
+//         size_t size() const { return m_size; }
+// };
+//
+// // 上の2つを組み合わせたLRUリスト
+// // 追い出した要素はコンテナから外して返すだけなので，呼び出し側がその領域を再利用できる
+// struct lru_tag{};
+//
+// template<typename T, typename Key>
+// class lru{
+//         ilist<T, lru_tag> m_list;
+//         ihash<T, Key, lru_tag> m_index;
+//         size_t m_capacity;
+// public:
+//         using list_hook=typename ilist<T, lru_tag>::hook;
+//         using hash_hook=typename ihash<T, Key, lru_tag>::hook;
+//
+//         explicit lru(size_t capacity):m_index{capacity}, m_capacity{capacity}{}
+//
+//         // 見つかった要素は先頭に移動する
+//         T* find(Key const& key)
+//         {
+//                 T* p=m_index.find(key);
+//                 if(p){
+//                         m_list.erase(*p);
+//                         m_list.push_front(*p);
+//                 }
+//                 return p;
+//         }
+//
+//         bool full() const { return m_list.size()==m_capacity; }
+//
+//         void insert(T& x)
+//         {
+//                 m_list.push_front(x);
+//                 m_index.insert(x);
+//         }
+//
+//         T* evict()
+//         {
+//                 if(m_list.empty()){
+//                         return nullptr;
+//                 }
+//                 T& x=m_list.back();
+//                 m_list.erase(x);
+//                 m_index.erase(x);
+//                 return &x;
+//         }
+// };
+//
+// // Entryはこの時点では不完全型だが，フックは要素の型を使わないので基底クラスにできる
+// struct Entry: lru<Entry, int>::list_hook, lru<Entry, int>::hash_hook{
+//         int m_key=0;
+//         int m_value=0;
+//
+//         int key() const
+//         {
+//                 return m_key;
+//         }
+// };
+//
+// void demo_lru()
+// {
+//         int const capacity=3;
+//         vector<Entry> pool(capacity); // 要素の領域は最初に確保しておく
+//         lru<Entry, int> cache(capacity);
+//         size_t used=0;
+//
+//         for(int key: {1, 2, 3, 1, 4, 5, 1}){
+//                 if(Entry* e=cache.find(key)){
+//                         cout << "hit  " << key << " -> " << e->m_value << '\n';
+//                         continue;
+//                 }
+//
+//                 // 追い出した要素を再利用するので，ここでも動的確保は起きない
+//                 Entry* e=cache.full() ? cache.evict() : &pool[used++];
+//                 e->m_key=key;
+//                 e->m_value=key*1987;
+//                 cache.insert(*e);
+//                 cout << "miss " << key << '\n';
+//         }
+// }
+
+
 /**
  * ローカルクラスの仕様を確認したい
  */
@@ -765,23 +1448,165 @@ using namespace std;
 
 
 /**
- * friend宣言でのinline指定の仕様を確認したい
+ * ローカルstatic変数の初期化ガードを避けたシングルトンを作りたい
+ * [stmt.dcl],[basic.stc.thread]
  */
-// // friend宣言でinline指定する場合，その宣言は定義であるか，またはinline指定された前方宣言を持たなくてはいけない
-// struct X{
-//     friend inline void f();
-// };
+// // ブロックスコープのstatic変数は，初めて制御が宣言を通過した時にスレッドセーフに初期化される
+// // そのためコンパイラは，アクセスの度に初期化済みかどうかのガード変数を確認するコードを生成する
+// // ループ内で何度も呼ばれると，このガードの確認(acquireロード，分岐，関数呼び出し)が無視できなくなる
+// // 初期化を明示的な段階に分け，初期化後のポインタをスレッドローカルに覚えておくと，
+// // 2回目以降は thread_local なポインタを読むだけになる
+// // thread_local変数は定数初期化(nullptr)なので，動的初期化のためのラッパー関数も呼ばれない
+// // ただしx86ではacquireロードも通常のロードと同じ命令になるので，差はほとんど出ない
+// // ARMなどではガードの確認にldar(acquire付きロード)が使われるので，通常のロードで済む分だけ差が出る
+// //
+// // 初期化した順番と時刻を記録して，起動時に何が初期化されたかを確認できるようにする
+// // 時刻はプログラムの開始からではなく，記録された中で最も早く始まった初期化からの経過時間
+// struct init_report{
+//         struct entry{
+//                 char const* name;
+//                 bool lazy; // get()から遅延初期化された
+//                 chrono::steady_clock::time_point start;
+//                 double took_us; // 初期化にかかった時間
+//         };
 //
-// void f(){}
-// // ill-formedだが，GCC, Clang, VC++いずれもエラーは出力せず
-
-
-/**
- * 非inline関数を定義後，それをinlineとして再宣言できないことを確認したい
- */
-// void f(){}
+//         static inline mutex s_mtx;
+//         static inline vector<entry> s_entries;
 //
-// inline void f(); // ill-formed
+//         static void add(entry e)
+//         {
+//                 lock_guard<mutex> lock(s_mtx);
+//                 s_entries.push_back(e);
+//         }
+//
+//         static void print()
+//         {
+//                 lock_guard<mutex> lock(s_mtx);
+//                 if(s_entries.empty()){
+//                         return;
+//                 }
+//                 // 別々の型の初期化は並行に走るので，記録した順と始まった順は一致するとは限らない
+//                 auto first=min_element(s_entries.begin(), s_entries.end(), [](entry const& a, entry const& b){ return a.start<b.start; })->start;
+//                 for(auto& e: s_entries){
+//                         chrono::duration<double, micro> at=e.start-first;
+//                         cout << e.name << (e.lazy ? " (lazy)" : " (init)")
+//                              << " at " << at.count() << " us, took " << e.took_us << " us" << '\n';
+//                 }
+//         }
+// };
+//
+// // Tは静的メンバ name を持つものとする
+// template<typename T>
+// class lazy_singleton{
+//         static inline once_flag s_once;
+//         static inline atomic<T*> s_instance{nullptr};
+//         static inline thread_local T* t_cache=nullptr;
+//
+//         static T& create(bool lazy)
+//         {
+//                 call_once(s_once, [lazy]{
+//                         auto start=chrono::steady_clock::now();
+//                         s_instance.store(new T, memory_order_release); // 終了時まで破棄しない
+//                         auto end=chrono::steady_clock::now();
+//
+//                         chrono::duration<double, micro> took=end-start;
+//                         init_report::add({T::name, lazy, start, took.count()});
+//                 });
+//                 return *s_instance.load(memory_order_acquire);
+//         }
+//
+//         // 初めてアクセスしたスレッドだけが通る
+//         static T& slow_get()
+//         {
+//                 T* p=&create(true);
+//                 t_cache=p;
+//                 return *p;
+//         }
+// public:
+//         // 起動時にまとめて呼んでおく
+//         static void init()
+//         {
+//                 t_cache=&create(false);
+//         }
+//
+//         static T& get()
+//         {
+//                 T* p=t_cache;
+//                 if(p){
+//                         return *p;
+//                 }
+//                 return slow_get();
+//         }
+// };
+//
+// // コンストラクタが定数式でない場合，ローカルstatic変数は動的初期化となりガード変数が必要になる
+// struct Config{
+//         static constexpr char const* name="Config";
+//         int m_level;
+//
+//         Config():m_level{getenv("LEVEL") ? 2 : 1}{}
+// };
+//
+// struct Logger{
+//         static constexpr char const* name="Logger";
+//         int m_count=0;
+// };
+//
+// // 比較用のローカルstatic変数を使う書き方
+// inline Config& config()
+// {
+//         static Config c; // アクセスの度にガード変数を確認する
+//         return c;
+// }
+//
+// void bench_singleton()
+// {
+//         lazy_singleton<Config>::init();
+//
+//         int const n=100'000'000;
+//         long long sum=0;
+//
+//         auto t0=chrono::steady_clock::now();
+//         for(int i=0; i<n; ++i){
+//                 sum+=config().m_level;
+//                 config().m_level^=1;
+//         }
+//
+//         auto t1=chrono::steady_clock::now();
+//         for(int i=0; i<n; ++i){
+//                 sum+=lazy_singleton<Config>::get().m_level;
+//                 lazy_singleton<Config>::get().m_level^=1;
+//         }
+//
+//         auto t2=chrono::steady_clock::now();
+//         thread([]{ ++lazy_singleton<Logger>::get().m_count; }).join(); // 別スレッドから遅延初期化される
+//
+//         chrono::duration<double, nano> d1=t1-t0, d2=t2-t1;
+//         cout << "local static:   " << d1.count()/n << " ns/iter" << '\n';
+//         cout << "lazy_singleton: " << d2.count()/n << " ns/iter" << '\n';
+//         cout << sum << '\n';
+//         init_report::print();
+// }
+
+
+/**
+ * friend宣言でのinline指定の仕様を確認したい
+ */
+// // friend宣言でinline指定する場合，その宣言は定義であるか，またはinline指定された前方宣言を持たなくてはいけない
+// struct X{
+//     friend inline void f();
+// };
+//
+// void f(){}
+// // ill-formedだが，GCC, Clang, VC++いずれもエラーは出力せず
+
+
+/**
+ * 非inline関数を定義後，それをinlineとして再宣言できないことを確認したい
+ */
+// void f(){}
+//
+// inline void f(); // ill-formed
 // // NDR(No Diagnostic is Required)のためエラーを出すかはコンパイラ依存
 // // GCC, VC++ではエラーは出ず，Clangではエラーが出る
 
@@ -902,6 +1727,389 @@ using namespace std;
 // static_cast<void>(x); // OK
 
 
+/**
+ * 数値の配列をまとめて飽和させながら型変換したい
+ * [conv.fpint],[conv.integral],[expr.static.cast]
+ */
+// // 上の例のstatic_cast<int>(x)は，xが変換先の範囲外(NaNも)だと未定義の動作になる
+// // 信号処理で大きな配列をfloat/doubleとint16_t/int32_tの間で変換する時に，1要素ずつ範囲を確かめてから変換すると遅い
+// // ・範囲外は最小値か最大値に，NaNは0にする(飽和)
+// // ・整数への丸め方は最近接偶数，0方向，負の無限大方向，正の無限大方向から選ぶ
+// //   丸め方はテンプレート引数にして，ループの外で1回だけ分岐する
+// // ・float/double/int32_t → int32_t/int16_t はSIMDで変換する
+// //   SSE4.1，AVX2，AVX-512の版を関数のtarget属性でそれぞれコンパイルし，実行時にCPUが対応している最も広いものを選ぶ
+// //   (-march=nativeを付けなくても，配布したバイナリが実行するマシンに合わせて速くなる)
+// //   まず丸めてからint32_tの範囲に飽和させ，int16_tへはpacksの飽和で縮める
+// // ・それ以外の組み合わせ(整数から浮動小数点数，int16_t → int32_tなど)は範囲外にならないので，そのまま変換する
+// //   double → floatで有限の範囲外の値は±FLT_MAXにし，無限大とNaNはそのままにする
+// // ・整数どうしは，符号の異なる型をcommon_typeで比べると符号無しになって負の値が大きな値になるので，符号と大きさを分けて比べる
+// // ・std::spanはC++20なので，先頭のポインタと要素数で渡す
+// enum class rounding{
+//         nearest, // 最近接偶数(既定の浮動小数点環境を前提にする)
+//         toward_zero,
+//         down,
+//         up,
+// };
+//
+// template<rounding R, typename T>
+// T round_as(T x)
+// {
+//         if constexpr(R==rounding::nearest){
+//                 return nearbyint(x);
+//         }else if constexpr(R==rounding::toward_zero){
+//                 return trunc(x);
+//         }else if constexpr(R==rounding::down){
+//                 return floor(x);
+//         }else{
+//                 return ceil(x);
+//         }
+// }
+//
+// template<typename To, rounding R=rounding::toward_zero, typename From>
+// To saturate_cast(From x)
+// {
+//         if constexpr(is_floating_point_v<From> && is_integral_v<To>){
+//                 if(x!=x){
+//                         return 0;
+//                 }
+//                 x=round_as<R>(x);
+//                 if(x<=static_cast<From>(numeric_limits<To>::min())){
+//                         return numeric_limits<To>::min();
+//                 }
+//                 if(x>=static_cast<From>(numeric_limits<To>::max())){ // floatではINT32_MAXが2^31に丸まるので>=で比べる
+//                         return numeric_limits<To>::max();
+//                 }
+//                 return static_cast<To>(x);
+//         }else if constexpr(is_integral_v<From> && is_integral_v<To>){
+//                 if constexpr(is_signed_v<From>){
+//                         if(x<0){
+//                                 if constexpr(is_signed_v<To>){
+//                                         return static_cast<intmax_t>(x)<static_cast<intmax_t>(numeric_limits<To>::min()) ? numeric_limits<To>::min() : static_cast<To>(x);
+//                                 }else{
+//                                         return 0;
+//                                 }
+//                         }
+//                 }
+//                 // ここではx>=0なので，符号無しの最も広い型で比べられる
+//                 return static_cast<uintmax_t>(x)>static_cast<uintmax_t>(numeric_limits<To>::max()) ? numeric_limits<To>::max() : static_cast<To>(x);
+//         }else if constexpr(is_floating_point_v<From> && is_floating_point_v<To> && sizeof(To)<sizeof(From)){
+//                 if(isinf(x)){
+//                         return static_cast<To>(x);
+//                 }
+//                 return static_cast<To>(min<From>(max<From>(x, numeric_limits<To>::lowest()), numeric_limits<To>::max())); // NaNはNaNのまま
+//         }else{
+//                 return static_cast<To>(x);
+//         }
+// }
+//
+// template<rounding R, typename From, typename To>
+// void convert_scalar(From const* in, size_t n, To* out)
+// {
+//         for(size_t i=0; i<n; ++i){
+//                 out[i]=saturate_cast<To, R>(in[i]);
+//         }
+// }
+//
+// enum class isa{
+//         scalar,
+//         sse41,
+//         avx2,
+//         avx512,
+// };
+//
+// isa best_isa()
+// {
+// #if defined(__x86_64__) && defined(__GNUC__)
+//         static isa const best=[]{
+//                 __builtin_cpu_init();
+//                 return __builtin_cpu_supports("avx512f") ? isa::avx512
+//                      : __builtin_cpu_supports("avx2") ? isa::avx2
+//                      : __builtin_cpu_supports("sse4.1") ? isa::sse41
+//                      : isa::scalar;
+//         }();
+//         return best;
+// #else
+//         return isa::scalar;
+// #endif
+// }
+//
+// #if defined(__x86_64__) && defined(__GNUC__)
+// template<rounding R>
+// constexpr int round_imm=(R==rounding::nearest ? _MM_FROUND_TO_NEAREST_INT : R==rounding::toward_zero ? _MM_FROUND_TO_ZERO
+//                        : R==rounding::down ? _MM_FROUND_TO_NEG_INF : _MM_FROUND_TO_POS_INF)|_MM_FROUND_NO_EXC;
+//
+// // 各ISAで，先頭からint32_tのレーン数分を丸めてint32_tに飽和させる
+// // NaNは先に0にし，floatの2^31以上はcvttが返す0x80000000を反転してINT32_MAXにする
+// template<rounding R>
+// __attribute__((target("sse4.1"))) inline __m128i to_i32_sse41(float const* p)
+// {
+//         __m128 x=_mm_loadu_ps(p);
+//         x=_mm_round_ps(_mm_and_ps(x, _mm_cmpord_ps(x, x)), round_imm<R>);
+//         __m128i over=_mm_castps_si128(_mm_cmpge_ps(x, _mm_set1_ps(2147483648.f)));
+//         return _mm_xor_si128(_mm_cvttps_epi32(x), over);
+// }
+//
+// // doubleはint32_tの範囲を正確に表せるので，丸めた後に範囲内に収めてから変換する
+// // (ラムダ式にはtarget属性が引き継がれないので，関数に分ける)
+// template<rounding R>
+// __attribute__((target("sse4.1"))) inline __m128i to_i32_sse41(__m128d x)
+// {
+//         x=_mm_round_pd(_mm_and_pd(x, _mm_cmpord_pd(x, x)), round_imm<R>);
+//         return _mm_cvttpd_epi32(_mm_min_pd(_mm_max_pd(x, _mm_set1_pd(-2147483648.0)), _mm_set1_pd(2147483647.0)));
+// }
+//
+// template<rounding R>
+// __attribute__((target("sse4.1"))) inline __m128i to_i32_sse41(double const* p)
+// {
+//         return _mm_unpacklo_epi64(to_i32_sse41<R>(_mm_loadu_pd(p)), to_i32_sse41<R>(_mm_loadu_pd(p+2)));
+// }
+//
+// template<rounding R>
+// __attribute__((target("sse4.1"))) inline __m128i to_i32_sse41(int32_t const* p)
+// {
+//         return _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+// }
+//
+// template<rounding R, typename From, typename To>
+// __attribute__((target("sse4.1"))) void convert_sse41(From const* in, size_t n, To* out)
+// {
+//         size_t i=0;
+//         for(; i+8<=n; i+=8){
+//                 __m128i a=to_i32_sse41<R>(in+i), b=to_i32_sse41<R>(in+i+4);
+//                 if constexpr(is_same_v<To, int16_t>){
+//                         _mm_storeu_si128(reinterpret_cast<__m128i*>(out+i), _mm_packs_epi32(a, b));
+//                 }else{
+//                         _mm_storeu_si128(reinterpret_cast<__m128i*>(out+i), a);
+//                         _mm_storeu_si128(reinterpret_cast<__m128i*>(out+i+4), b);
+//                 }
+//         }
+//         convert_scalar<R>(in+i, n-i, out+i);
+// }
+//
+// template<rounding R>
+// __attribute__((target("avx2"))) inline __m256i to_i32_avx2(float const* p)
+// {
+//         __m256 x=_mm256_loadu_ps(p);
+//         x=_mm256_round_ps(_mm256_and_ps(x, _mm256_cmp_ps(x, x, _CMP_ORD_Q)), round_imm<R>);
+//         __m256i over=_mm256_castps_si256(_mm256_cmp_ps(x, _mm256_set1_ps(2147483648.f), _CMP_GE_OQ));
+//         return _mm256_xor_si256(_mm256_cvttps_epi32(x), over);
+// }
+//
+// template<rounding R>
+// __attribute__((target("avx2"))) inline __m128i to_i32_avx2(__m256d x)
+// {
+//         x=_mm256_round_pd(_mm256_and_pd(x, _mm256_cmp_pd(x, x, _CMP_ORD_Q)), round_imm<R>);
+//         return _mm256_cvttpd_epi32(_mm256_min_pd(_mm256_max_pd(x, _mm256_set1_pd(-2147483648.0)), _mm256_set1_pd(2147483647.0)));
+// }
+//
+// template<rounding R>
+// __attribute__((target("avx2"))) inline __m256i to_i32_avx2(double const* p)
+// {
+//         return _mm256_inserti128_si256(_mm256_castsi128_si256(to_i32_avx2<R>(_mm256_loadu_pd(p))), to_i32_avx2<R>(_mm256_loadu_pd(p+4)), 1);
+// }
+//
+// template<rounding R>
+// __attribute__((target("avx2"))) inline __m256i to_i32_avx2(int32_t const* p)
+// {
+//         return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+// }
+//
+// template<rounding R, typename From, typename To>
+// __attribute__((target("avx2"))) void convert_avx2(From const* in, size_t n, To* out)
+// {
+//         size_t i=0;
+//         for(; i+16<=n; i+=16){
+//                 __m256i a=to_i32_avx2<R>(in+i), b=to_i32_avx2<R>(in+i+8);
+//                 if constexpr(is_same_v<To, int16_t>){
+//                         // packsは128ビットのレーンごとに縮めるので，64ビット単位で並べ直す
+//                         _mm256_storeu_si256(reinterpret_cast<__m256i*>(out+i), _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8));
+//                 }else{
+//                         _mm256_storeu_si256(reinterpret_cast<__m256i*>(out+i), a);
+//                         _mm256_storeu_si256(reinterpret_cast<__m256i*>(out+i+8), b);
+//                 }
+//         }
+//         convert_scalar<R>(in+i, n-i, out+i);
+// }
+//
+// template<rounding R>
+// __attribute__((target("avx512f"))) inline __m512i to_i32_avx512(float const* p)
+// {
+//         __m512 x=_mm512_loadu_ps(p);
+//         x=_mm512_roundscale_ps(_mm512_maskz_mov_ps(_mm512_cmp_ps_mask(x, x, _CMP_ORD_Q), x), round_imm<R>);
+//         return _mm512_mask_mov_epi32(_mm512_cvttps_epi32(x), _mm512_cmp_ps_mask(x, _mm512_set1_ps(2147483648.f), _CMP_GE_OQ), _mm512_set1_epi32(INT32_MAX));
+// }
+//
+// template<rounding R>
+// __attribute__((target("avx512f"))) inline __m256i to_i32_avx512(__m512d x)
+// {
+//         x=_mm512_roundscale_pd(_mm512_maskz_mov_pd(_mm512_cmp_pd_mask(x, x, _CMP_ORD_Q), x), round_imm<R>);
+//         return _mm512_cvttpd_epi32(_mm512_min_pd(_mm512_max_pd(x, _mm512_set1_pd(-2147483648.0)), _mm512_set1_pd(2147483647.0)));
+// }
+//
+// template<rounding R>
+// __attribute__((target("avx512f"))) inline __m512i to_i32_avx512(double const* p)
+// {
+//         return _mm512_inserti64x4(_mm512_castsi256_si512(to_i32_avx512<R>(_mm512_loadu_pd(p))), to_i32_avx512<R>(_mm512_loadu_pd(p+8)), 1);
+// }
+//
+// template<rounding R>
+// __attribute__((target("avx512f"))) inline __m512i to_i32_avx512(int32_t const* p)
+// {
+//         return _mm512_loadu_si512(p);
+// }
+//
+// template<rounding R, typename From, typename To>
+// __attribute__((target("avx512f"))) void convert_avx512(From const* in, size_t n, To* out)
+// {
+//         size_t i=0;
+//         for(; i+16<=n; i+=16){
+//                 __m512i a=to_i32_avx512<R>(in+i);
+//                 if constexpr(is_same_v<To, int16_t>){
+//                         _mm256_storeu_si256(reinterpret_cast<__m256i*>(out+i), _mm512_cvtsepi32_epi16(a));
+//                 }else{
+//                         _mm512_storeu_si512(out+i, a);
+//                 }
+//         }
+//         convert_scalar<R>(in+i, n-i, out+i);
+// }
+// #endif
+//
+// template<rounding R, typename From, typename To>
+// void convert_as(From const* in, size_t n, To* out, isa use)
+// {
+// #if defined(__x86_64__) && defined(__GNUC__)
+//         constexpr bool simd=(is_same_v<From, float> || is_same_v<From, double> || is_same_v<From, int32_t>)
+//                             && (is_same_v<To, int32_t> || is_same_v<To, int16_t>) && !is_same_v<From, To>;
+//         if constexpr(simd){
+//                 switch(use){
+//                 case isa::avx512:
+//                         return convert_avx512<R>(in, n, out);
+//                 case isa::avx2:
+//                         return convert_avx2<R>(in, n, out);
+//                 case isa::sse41:
+//                         return convert_sse41<R>(in, n, out);
+//                 case isa::scalar:
+//                         break;
+//                 }
+//         }
+// #endif
+//         convert_scalar<R>(in, n, out);
+// }
+//
+// // in[0, n)をTo型に変換してoutに書く，useは比較のために命令セットを指定する時だけ渡す
+// template<typename From, typename To>
+// void convert(From const* in, size_t n, To* out, rounding r=rounding::nearest, isa use=best_isa())
+// {
+//         switch(r){
+//         case rounding::nearest:
+//                 return convert_as<rounding::nearest>(in, n, out, use);
+//         case rounding::toward_zero:
+//                 return convert_as<rounding::toward_zero>(in, n, out, use);
+//         case rounding::down:
+//                 return convert_as<rounding::down>(in, n, out, use);
+//         case rounding::up:
+//                 return convert_as<rounding::up>(in, n, out, use);
+//         }
+// }
+//
+// template<typename From, typename To>
+// void bench_convert(char const* name, size_t n)
+// {
+//         // 値の1割は変換先の範囲外かNaNにする，static_castの比較用には範囲内の値だけの配列を使う
+//         mt19937 gen(1987);
+//         vector<From> in(n), in_range(n);
+//         for(size_t i=0; i<n; ++i){
+//                 double v=uniform_real_distribution<double>(-40000, 40000)(gen);
+//                 in_range[i]=static_cast<From>(is_same_v<To, int16_t> ? v*0.8 : v);
+//                 in[i]=in_range[i];
+//                 if(gen()%10==0){
+//                         in[i]=gen()%2 ? numeric_limits<From>::max() : numeric_limits<From>::lowest();
+//                 }
+//                 if constexpr(is_floating_point_v<From>){
+//                         if(gen()%50==0){
+//                                 in[i]=numeric_limits<From>::quiet_NaN();
+//                         }
+//                 }
+//         }
+//         vector<To> out(n), expect(n);
+//
+//         auto run=[&](char const* label, auto f){
+//                 auto start=chrono::steady_clock::now();
+//                 for(int k=0; k<10; ++k){
+//                         f();
+//                 }
+//                 chrono::duration<double, nano> d=chrono::steady_clock::now()-start;
+//                 cout << "  " << label << d.count()/(10*n) << " ns/elem" << '\n';
+//         };
+//
+//         cout << name << '\n';
+//         run("static_cast (in range) ", [&]{
+//                 for(size_t i=0; i<n; ++i){
+//                         out[i]=static_cast<To>(in_range[i]);
+//                 }
+//         });
+//         run("clamp + static_cast    ", [&]{ convert_scalar<rounding::toward_zero>(in.data(), n, expect.data()); });
+//         bool same=true;
+//         for(auto [use, label]: {pair{isa::sse41, "sse4.1                 "}, pair{isa::avx2, "avx2                   "}, pair{isa::avx512, "avx-512                "}}){
+//                 if(use>best_isa()){
+//                         continue;
+//                 }
+//                 run(label, [&]{ convert(in.data(), n, out.data(), rounding::toward_zero, use); });
+//                 same&=out==expect;
+//         }
+//
+//         // 丸め方ごとに，SIMDとスカラーの結果が一致するか
+//         for(rounding r: {rounding::nearest, rounding::down, rounding::up}){
+//                 convert(in.data(), n, out.data(), r, isa::scalar);
+//                 convert(in.data(), n, expect.data(), r);
+//                 same&=out==expect;
+//         }
+//         cout << "  same as scalar: " << boolalpha << same << endl;
+// }
+//
+// void bench_convert()
+// {
+//         size_t const n=1<<22;
+//         bench_convert<float, int32_t>("float -> int32_t", n);
+//         bench_convert<float, int16_t>("float -> int16_t", n);
+//         bench_convert<double, int32_t>("double -> int32_t", n);
+//         bench_convert<double, int16_t>("double -> int16_t", n);
+//         bench_convert<int32_t, int16_t>("int32_t -> int16_t", n);
+//
+//         // 境界の値，AVX-512のループ(16要素)と端数の処理の両方を通るように24要素にする
+//         float edge[]={-INFINITY, -1e30f, -2147483904.f, -2147483648.f, -32769.f, -32768.5f, -2.5f, -1.5f,
+//                       -0.5f, -0.f, 1e-30f, 0.5f, 1.5f, 2.5f, 3.5f, 32766.5f,
+//                       32767.5f, 65535.5f, 2147483520.f, 2147483648.f, 1e30f, INFINITY, NAN, -NAN};
+//         int16_t s16[size(edge)], v16[size(edge)];
+//         int32_t s32[size(edge)], v32[size(edge)];
+//         bool same=true;
+//         for(rounding r: {rounding::nearest, rounding::toward_zero, rounding::down, rounding::up}){
+//                 convert(edge, size(edge), s16, r, isa::scalar);
+//                 convert(edge, size(edge), s32, r, isa::scalar);
+//                 for(isa use: {isa::sse41, isa::avx2, isa::avx512}){
+//                         if(use>best_isa()){
+//                                 continue;
+//                         }
+//                         convert(edge, size(edge), v16, r, use);
+//                         convert(edge, size(edge), v32, r, use);
+//                         same&=equal(s16, s16+size(edge), v16) && equal(s32, s32+size(edge), v32);
+//                 }
+//         }
+//         convert(edge, size(edge), s16);
+//         convert(edge, size(edge), s32);
+//         for(size_t i=0; i<size(edge); ++i){
+//                 cout << edge[i] << ":" << s16[i] << "," << s32[i] << ' ';
+//         }
+//         cout << '\n' << "edge cases same on every isa: " << boolalpha << same << '\n';
+//
+//         // 符号の異なる整数どうし
+//         cout << saturate_cast<int32_t>(uint64_t{5}) << ' ' << saturate_cast<uint64_t>(int64_t{-1}) << ' '
+//              << saturate_cast<int16_t>(uint32_t{70000}) << ' ' << saturate_cast<uint16_t>(int64_t{-70000}) << ' '
+//              << saturate_cast<int64_t>(numeric_limits<uint64_t>::max()) << ' ' << saturate_cast<float>(1e300) << ' '
+//              << saturate_cast<float>(-numeric_limits<double>::infinity()) << endl;
+// }
+
+
 /**
  * 関数ポインタをconst_castできないことを確認したい
  */
@@ -934,6 +2142,202 @@ using namespace std;
 // cout << static_cast<char*>(p) << endl;
 
 
+/**
+ * void*を配るバンプアロケータをstatic_castで型付けして使いたい
+ * [expr.static.cast],[basic.align],[mem.res.class]
+ */
+// // 上の例のように T* → void* → T* はstatic_castで元の値に戻る
+// // そこで領域の確保は型を持たない void* で行い，型付けは利用側のstatic_castで行う
+// // 確保はポインタを進めるだけ(bump)で，個別の解放はしない
+// // 位置を記録しておき(marker)，そこまで巻き戻せば，それ以降に確保した領域をまとめてO(1)で解放できる
+// // 巻き戻してもブロックは解放せずに再利用するので，定常状態ではmallocを呼ばない
+// // デストラクタは呼ばれないので，makeで作れるのはトリビアルに破棄可能な型だけにする
+// // pmr::memory_resourceを継承すると，pmr::vectorなどの標準コンテナからも使える
+// class bump_arena: public pmr::memory_resource{
+//         struct block{
+//                 block* next;
+//                 size_t size;
+//
+//                 char* begin(){ return reinterpret_cast<char*>(this+1); }
+//                 char* end(){ return begin()+size; }
+//         };
+//
+//         block* m_first=nullptr;
+//         block* m_block=nullptr; // 現在確保しているブロック
+//         char* m_cur=nullptr;
+//         char* m_end=nullptr;
+//         size_t m_block_size;
+//
+//         void* grow(size_t n, size_t align)
+//         {
+//                 // 巻き戻した後は，既に確保してあるブロックを先頭から再利用する
+//                 block* b=m_block ? m_block->next : m_first;
+//                 while(b && b->size<n+align){
+//                         b=b->next;
+//                 }
+//                 if(!b){
+//                         size_t size=max(m_block_size, n+align);
+//                         b=static_cast<block*>(malloc(sizeof(block)+size));
+//                         if(!b){
+//                                 throw bad_alloc();
+//                         }
+//                         b->size=size;
+//                         block** link=m_block ? &m_block->next : &m_first;
+//                         b->next=*link;
+//                         *link=b;
+//                 }
+//                 m_block=b;
+//                 m_cur=b->begin();
+//                 m_end=b->end();
+//                 return allocate_raw(n, align);
+//         }
+//
+//         void* do_allocate(size_t n, size_t align) override
+//         {
+//                 return allocate_raw(n, align);
+//         }
+//
+//         void do_deallocate(void*, size_t, size_t) override {} // 個別には解放しない
+//
+//         bool do_is_equal(memory_resource const& other) const noexcept override
+//         {
+//                 return this==&other;
+//         }
+// public:
+//         struct marker{
+//                 block* b;
+//                 char* cur;
+//                 char* end;
+//         };
+//
+//         explicit bump_arena(size_t block_size=64*1024):m_block_size{block_size}{}
+//
+//         bump_arena(bump_arena const&)=delete;
+//         bump_arena& operator=(bump_arena const&)=delete;
+//
+//         ~bump_arena()
+//         {
+//                 while(m_first){
+//                         free(exchange(m_first, m_first->next));
+//                 }
+//         }
+//
+//         void* allocate_raw(size_t n, size_t align=alignof(max_align_t))
+//         {
+//                 auto p=reinterpret_cast<uintptr_t>(m_cur);
+//                 auto aligned=(p+align-1)&~(uintptr_t{align}-1);
+//                 if(!m_cur || aligned+n>reinterpret_cast<uintptr_t>(m_end)){
+//                         return grow(n, align);
+//                 }
+//                 m_cur=reinterpret_cast<char*>(aligned+n);
+//                 return reinterpret_cast<void*>(aligned);
+//         }
+//
+//         template<typename T, typename ... Args>
+//         T* make(Args&& ... args)
+//         {
+//                 static_assert(is_trivially_destructible_v<T>, "デストラクタは呼ばれない");
+//                 void* p=allocate_raw(sizeof(T), alignof(T));
+//                 return ::new(p) T{forward<Args>(args)...};
+//         }
+//
+//         template<typename T>
+//         T* make_array(size_t n)
+//         {
+//                 static_assert(is_trivially_destructible_v<T>, "デストラクタは呼ばれない");
+//                 T* p=static_cast<T*>(allocate_raw(n*sizeof(T), alignof(T)));
+//                 uninitialized_default_construct_n(p, n); // トリビアルな型であれば何もしない
+//                 return p;
+//         }
+//
+//         marker mark() const
+//         {
+//                 return {m_block, m_cur, m_end};
+//         }
+//
+//         // O(1)，後に確保したブロックは次の確保で再利用される
+//         void rewind(marker m)
+//         {
+//                 m_block=m.b;
+//                 m_cur=m.cur;
+//                 m_end=m.end;
+//         }
+// };
+//
+// // スコープを抜ける時に，スコープ内で確保した領域をまとめて解放する
+// class arena_scope{
+//         bump_arena& m_arena;
+//         bump_arena::marker m_mark;
+// public:
+//         explicit arena_scope(bump_arena& arena):m_arena{arena}, m_mark{arena.mark()}{}
+//         arena_scope(arena_scope const&)=delete;
+//         arena_scope& operator=(arena_scope const&)=delete;
+//
+//         ~arena_scope()
+//         {
+//                 m_arena.rewind(m_mark);
+//         }
+// };
+//
+// struct Node{
+//         int key;
+//         Node* next;
+// };
+//
+// // 1リクエストで，16〜256バイトの領域を64回確保して最後にまとめて解放する
+// void bench_arena(int requests)
+// {
+//         int const per_request=64;
+//         size_t sizes[per_request];
+//         for(int i=0; i<per_request; ++i){
+//                 sizes[i]=16+(i*37)%241;
+//         }
+//
+//         auto t0=chrono::steady_clock::now();
+//         for(int r=0; r<requests; ++r){
+//                 void* ps[per_request];
+//                 for(int i=0; i<per_request; ++i){
+//                         ps[i]=malloc(sizes[i]);
+//                         static_cast<char*>(ps[i])[0]=1;
+//                 }
+//                 for(int i=0; i<per_request; ++i){
+//                         free(ps[i]);
+//                 }
+//         }
+//
+//         auto t1=chrono::steady_clock::now();
+//         for(int r=0; r<requests; ++r){
+//                 pmr::monotonic_buffer_resource mr;
+//                 for(int i=0; i<per_request; ++i){
+//                         static_cast<char*>(mr.allocate(sizes[i]))[0]=1;
+//                 }
+//         }
+//
+//         auto t2=chrono::steady_clock::now();
+//         bump_arena arena;
+//         for(int r=0; r<requests; ++r){
+//                 arena_scope scope(arena);
+//                 for(int i=0; i<per_request; ++i){
+//                         static_cast<char*>(arena.allocate_raw(sizes[i]))[0]=1;
+//                 }
+//         }
+//
+//         auto t3=chrono::steady_clock::now();
+//         auto per=[requests](auto d){ return chrono::duration<double, nano>(d).count()/requests; };
+//         cout << "malloc:    " << per(t1-t0) << " ns/request" << '\n';
+//         cout << "monotonic: " << per(t2-t1) << " ns/request" << '\n';
+//         cout << "arena:     " << per(t3-t2) << " ns/request" << '\n';
+//
+//         // 型付きの確保と，標準コンテナからの使用
+//         arena_scope scope(arena);
+//         Node* n=arena.make<Node>(1987, nullptr);
+//         int* a=arena.make_array<int>(10);
+//         pmr::vector<int> v({1, 2, 3}, &arena);
+//         a[0]=n->key+v[2];
+//         cout << a[0] << endl;
+// }
+
+
 /**
  * 関数の引数の型のルールを確認したい
  */
@@ -1206,58 +2610,5035 @@ using namespace std;
 
 
 /**
- * 無名unionの仕様を確認したい
+ * 構造体の配列(AoS)を配列の構造体(SoA)として持ちたい
+ * [tuple.tuple],[dcl.struct.bind],[basic.align]
  */
-// 無名unionは，メンバ関数を持てないためアクセス指定子も指定できない
-// 無名unionは，非staticメンバ変数しか持てない
-// 名前空間スコープで宣言する際はstaticを指定しなくてはいけない
-// void f()
-// {
-//         union {
-//                 char c;
-//                 int i;
+// // 上のstruct X{ int data; ... } や，stringstreamの例の m，s，f のようなレコードを vector<struct> で持つと，
+// // メモリ上には m s f m s f ... と並ぶ(Array of Structures)
+// // 1つのフィールドだけを走査する場合でも，他のフィールドまでキャッシュに読み込むことになる
+// // フィールド毎に連続した配列を持つ(Structure of Arrays)と，走査するフィールドだけが読み込まれ，
+// // 同じ型の値が連続するのでコンパイラによるベクトル化もしやすい
+// // 要素へのアクセスは tuple<Fields&...> を返すことで，構造化束縛を使って構造体のように書ける
+// template<typename ... Fields>
+// class soa_vector{
+//         static_assert((is_trivially_copyable_v<Fields> && ...), "列はmemcpyで移動する");
+//
+//         static constexpr size_t N=sizeof...(Fields);
+//         static constexpr align_val_t align{64}; // キャッシュラインとAVX-512のベクトル幅に合わせる
+//
+//         struct deleter{
+//                 void operator()(void* p) const { ::operator delete(p, align); }
 //         };
-// }
-
-
-/**
- * (i/o)stringstreamの使い方を確認したい
- */
-// char str[]={"1987 hoge 3.14"};
-// int m;
-// char s[10]={};
+//
+//         template<typename T>
+//         using column_ptr=unique_ptr<T, deleter>;
+//
+//         tuple<column_ptr<Fields>...> m_cols{};
+//         size_t m_size=0;
+//         size_t m_capacity=0;
+//
+//         template<typename T>
+//         static column_ptr<T> allocate(size_t capacity)
+//         {
+//                 return column_ptr<T>(static_cast<T*>(::operator new(capacity*sizeof(T), align)));
+//         }
+//
+//         // 新しい列を全て確保できてから入れ替えるので，途中でbad_allocが投げられても元のまま(確保済みの列は解放される)
+//         template<size_t ... Is>
+//         void reallocate(size_t capacity, index_sequence<Is...>)
+//         {
+//                 tuple<column_ptr<Fields>...> cols{allocate<Fields>(capacity)...};
+//                 ((m_size ? static_cast<void>(memcpy(get<Is>(cols).get(), get<Is>(m_cols).get(), m_size*sizeof(Fields))) : static_cast<void>(0)), ...);
+//                 m_cols.swap(cols);
+//                 m_capacity=capacity;
+//         }
+//
+//         template<typename Ref, size_t ... Is>
+//         Ref at(size_t i, index_sequence<Is...>) const
+//         {
+//                 return {get<Is>(m_cols).get()[i]...};
+//         }
+// public:
+//         using reference=tuple<Fields&...>;
+//         using const_reference=tuple<Fields const&...>;
+//
+//         template<typename Ref>
+//         class basic_iterator{
+//                 soa_vector const* m_v;
+//                 size_t m_i;
+//         public:
+//                 basic_iterator(soa_vector const* v, size_t i):m_v{v}, m_i{i}{}
+//                 Ref operator*() const { return m_v->template at<Ref>(m_i, make_index_sequence<N>{}); }
+//                 basic_iterator& operator++(){ ++m_i; return *this; }
+//                 bool operator!=(basic_iterator const& other) const { return m_i!=other.m_i; }
+//         };
+//         using iterator=basic_iterator<reference>;
+//         using const_iterator=basic_iterator<const_reference>;
+//
+//         soa_vector()=default;
+//         soa_vector(soa_vector const&)=delete;
+//         soa_vector& operator=(soa_vector const&)=delete;
+//
+//         void reserve(size_t capacity)
+//         {
+//                 if(capacity>m_capacity){
+//                         reallocate(capacity, make_index_sequence<N>{});
+//                 }
+//         }
+//
+//         // 値で受け取る，soa.push_back(get<0>(soa[0]), ...)のように自分の要素を渡されても，reserveで古い列を解放する前にコピーされている
+//         void push_back(Fields ... fs)
+//         {
+//                 if(m_size==m_capacity){
+//                         reserve(m_capacity ? m_capacity*2 : 16);
+//                 }
+//                 size_t i=m_size++;
+//                 apply([&](column_ptr<Fields> const& ... cols){ ((cols.get()[i]=fs), ...); }, m_cols);
+//         }
+//
+//         reference operator[](size_t i)
+//         {
+//                 return at<reference>(i, make_index_sequence<N>{});
+//         }
+//
+//         const_reference operator[](size_t i) const
+//         {
+//                 return at<const_reference>(i, make_index_sequence<N>{});
+//         }
+//
+//         reference at(size_t i)
+//         {
+//                 if(i>=m_size){
+//                         throw out_of_range("soa_vector::at");
+//                 }
+//                 return (*this)[i];
+//         }
+//
+//         const_reference at(size_t i) const
+//         {
+//                 if(i>=m_size){
+//                         throw out_of_range("soa_vector::at");
+//                 }
+//                 return (*this)[i];
+//         }
+//
+//         // I番目のフィールドの連続した配列
+//         template<size_t I>
+//         auto* column()
+//         {
+//                 return get<I>(m_cols).get();
+//         }
+//
+//         template<size_t I>
+//         auto const* column() const
+//         {
+//                 return get<I>(m_cols).get();
+//         }
+//
+//         size_t size() const { return m_size; }
+//         iterator begin() { return {this, 0}; }
+//         iterator end() { return {this, m_size}; }
+//         const_iterator begin() const { return {this, 0}; }
+//         const_iterator end() const { return {this, m_size}; }
+// };
+//
+// // 文字列は別の表に置いてIDで持つことにする
+// struct Record{
+//         int m;
+//         char s[10];
+//         float f;
+// };
+//
+// void bench_soa()
+// {
+//         int const n=10'000'000;
+//         vector<Record> aos;
+//         soa_vector<int, unsigned, float> soa;
+//         aos.reserve(n);
+//         soa.reserve(n);
+//         for(int i=0; i<n; ++i){
+//                 aos.push_back({1987+i%7, "hoge", 3.14f});
+//                 soa.push_back(1987+i%7, 0, 3.14f);
+//         }
+//
+//         // 構造体のように書ける，sは参照なので書き換えも反映される
+//         for(auto [m, s, f]: soa){
+//                 s=static_cast<unsigned>(m%2);
+//         }
+//
+//         auto t0=chrono::steady_clock::now();
+//         long long sum1=0;
+//         for(auto const& r: aos){
+//                 sum1+=r.m;
+//         }
+//
+//         auto t1=chrono::steady_clock::now();
+//         long long sum2=0;
+//         int const* m=soa.column<0>();
+//         for(size_t i=0; i<soa.size(); ++i){
+//                 sum2+=m[i]; // 連続したintの和なのでベクトル化される
+//         }
+//
+//         auto t2=chrono::steady_clock::now();
+//         float max1=0;
+//         for(auto const& r: aos){
+//                 max1=max(max1, r.f);
+//         }
+//
+//         auto t3=chrono::steady_clock::now();
+//         float max2=0;
+//         float const* f=soa.column<2>();
+//         for(size_t i=0; i<soa.size(); ++i){
+//                 max2=max(max2, f[i]); // NaNと-0.0の扱いが変わるため，-ffinite-math-only -fno-signed-zerosが無いとベクトル化されない
+//         }
+//
+//         auto t4=chrono::steady_clock::now();
+//         chrono::duration<double, milli> d1=t1-t0, d2=t2-t1, d3=t3-t2, d4=t4-t3;
+//         cout << "sum m: aos " << d1.count() << " ms, soa " << d2.count() << " ms (" << sum1 << ", " << sum2 << ")" << '\n';
+//         cout << "max f: aos " << d3.count() << " ms, soa " << d4.count() << " ms (" << max1 << ", " << max2 << ")" << endl;
+// }
+
+
+/**
+ * 無名unionの仕様を確認したい
+ */
+// 無名unionは，メンバ関数を持てないためアクセス指定子も指定できない
+// 無名unionは，非staticメンバ変数しか持てない
+// 名前空間スコープで宣言する際はstaticを指定しなくてはいけない
+// void f()
+// {
+//         union {
+//                 char c;
+//                 int i;
+//         };
+// }
+
+
+/**
+ * 判別子付きの共用体(tagged union)をジャンプテーブルで訪問したい
+ * [class.union],[basic.align],[temp.variadic]
+ */
+// // 上の無名unionには，どのメンバが有効かを示す判別子が無い
+// // 判別子と共用体をまとめたクラスを作り，有効なメンバの型に応じた処理を1回の表引きで呼び出せるようにする
+// // ・判別子は選択肢の数に応じて最小の整数型(256個以下ならuint8_t)にする
+// // ・visitは関数ポインタの配列(ジャンプテーブル)を1回引くだけにする
+// //   複数のオブジェクトを同時に訪問する場合も，添字を1つにまとめて1つの表を引く
+// // ・全ての選択肢のムーブが例外を投げないことを要求し，値を失った状態(valueless)にならないようにする
+// namespace tu{
+//         // まとめた添字を，各オブジェクトの添字に戻す
+//         template<size_t ... Ns>
+//         constexpr array<size_t, sizeof...(Ns)> unflatten(size_t flat)
+//         {
+//                 array<size_t, sizeof...(Ns)> sizes{{Ns...}}, r{};
+//                 for(size_t k=sizeof...(Ns); k-->0;){
+//                         r[k]=flat%sizes[k];
+//                         flat/=sizes[k];
+//                 }
+//                 return r;
+//         }
+//
+//         template<size_t Flat, typename R, size_t ... Ks, typename F, typename ... Vs>
+//         R dispatch(index_sequence<Ks...>, F&& f, Vs&& ... vs)
+//         {
+//                 constexpr auto idx=unflatten<remove_reference_t<Vs>::size...>(Flat);
+//                 return forward<F>(f)(forward<Vs>(vs).template get_unchecked<idx[Ks]>()...);
+//         }
+//
+//         template<typename R, typename F, typename ... Vs, size_t ... Flats>
+//         constexpr auto make_table(index_sequence<Flats...>)
+//         {
+//                 using fp=R (*)(index_sequence_for<Vs...>, F&&, Vs&& ...);
+//                 return array<fp, sizeof...(Flats)>{{&dispatch<Flats, R>...}};
+//         }
+//
+//         template<typename F, typename ... Vs>
+//         decltype(auto) visit(F&& f, Vs&& ... vs)
+//         {
+//                 using R=decltype(forward<F>(f)(forward<Vs>(vs).template get_unchecked<0>()...));
+//                 constexpr size_t total=(remove_reference_t<Vs>::size*...*1);
+//                 static constexpr auto table=make_table<R, F, Vs...>(make_index_sequence<total>{});
+//
+//                 size_t flat=0;
+//                 ((flat=flat*remove_reference_t<Vs>::size+vs.index()), ...);
+//                 return table[flat](index_sequence_for<Vs...>{}, forward<F>(f), forward<Vs>(vs)...);
+//         }
+//
+//         template<typename ... Ts>
+//         class tagged_union{
+//                 static_assert((is_nothrow_move_constructible_v<Ts> && ...), "ムーブが例外を投げると値を失う");
+//
+//                 using tag_type=conditional_t<sizeof...(Ts)<=256, uint8_t, uint16_t>;
+//
+//                 template<size_t I>
+//                 using alt=tuple_element_t<I, tuple<Ts...>>;
+//
+//                 template<typename T>
+//                 static constexpr size_t index_of()
+//                 {
+//                         bool const same[]={is_same_v<T, Ts>...};
+//                         size_t i=0;
+//                         while(!same[i]){
+//                                 ++i;
+//                         }
+//                         return i;
+//                 }
+//
+//                 alignas(Ts...) unsigned char m_storage[max({sizeof(Ts)...})];
+//                 tag_type m_tag;
+//
+//                 void destroy() noexcept
+//                 {
+//                         if constexpr(!(is_trivially_destructible_v<Ts> && ...)){
+//                                 visit([](auto& v){ using T=decay_t<decltype(v)>; v.~T(); }, *this);
+//                         }
+//                 }
+//
+//                 template<typename U>
+//                 void construct_from(U&& other)
+//                 {
+//                         m_tag=other.m_tag;
+//                         visit([this](auto&& v){
+//                                 using T=decay_t<decltype(v)>;
+//                                 ::new(static_cast<void*>(m_storage)) T(forward<decltype(v)>(v));
+//                         }, forward<U>(other));
+//                 }
+//         public:
+//                 static constexpr size_t size=sizeof...(Ts);
+//
+//                 tagged_union():tagged_union(in_place_index<0>){}
+//
+//                 template<size_t I, typename ... Args>
+//                 explicit tagged_union(in_place_index_t<I>, Args&& ... args):m_tag{I}
+//                 {
+//                         ::new(static_cast<void*>(m_storage)) alt<I>{forward<Args>(args)...};
+//                 }
+//
+//                 template<typename T, typename=enable_if_t<(is_same_v<decay_t<T>, Ts> || ...)>>
+//                 tagged_union(T&& v):tagged_union(in_place_index<index_of<decay_t<T>>()>, forward<T>(v)){}
+//
+//                 tagged_union(tagged_union const& other)
+//                 {
+//                         construct_from(other);
+//                 }
+//
+//                 tagged_union(tagged_union&& other) noexcept
+//                 {
+//                         construct_from(move(other));
+//                 }
+//
+//                 // コピーを先に作ってからムーブするので，コピーが例外を投げても元の値は残る
+//                 tagged_union& operator=(tagged_union const& other)
+//                 {
+//                         return *this=tagged_union(other);
+//                 }
+//
+//                 tagged_union& operator=(tagged_union&& other) noexcept
+//                 {
+//                         if(this!=&other){
+//                                 destroy();
+//                                 construct_from(move(other));
+//                         }
+//                         return *this;
+//                 }
+//
+//                 ~tagged_union()
+//                 {
+//                         destroy();
+//                 }
+//
+//                 template<size_t I, typename ... Args>
+//                 alt<I>& emplace(Args&& ... args)
+//                 {
+//                         alt<I> tmp{forward<Args>(args)...}; // ここで例外が投げられても元の値は残る
+//                         destroy();
+//                         ::new(static_cast<void*>(m_storage)) alt<I>(move(tmp));
+//                         m_tag=I;
+//                         return get_unchecked<I>();
+//                 }
+//
+//                 size_t index() const noexcept
+//                 {
+//                         return m_tag;
+//                 }
+//
+//                 template<size_t I>
+//                 alt<I>& get_unchecked() & noexcept
+//                 {
+//                         return *launder(reinterpret_cast<alt<I>*>(m_storage));
+//                 }
+//
+//                 template<size_t I>
+//                 alt<I> const& get_unchecked() const& noexcept
+//                 {
+//                         return *launder(reinterpret_cast<alt<I> const*>(m_storage));
+//                 }
+//
+//                 template<size_t I>
+//                 alt<I>&& get_unchecked() && noexcept
+//                 {
+//                         return move(get_unchecked<I>());
+//                 }
+//         };
+// }
+//
+// // 判別子は1バイトで済む
+// static_assert(sizeof(tu::tagged_union<char, short>)==4);
+// static_assert(sizeof(tu::tagged_union<char, int>)==8);
+//
+// // 2つのオブジェクトを同時に訪問する，表は2*3=6要素になる
+// void demo_tagged_union()
+// {
+//         tu::tagged_union<int, double> a=3.14;
+//         tu::tagged_union<char, int, string> b=string("hoge");
+//
+//         tu::visit([](auto const& x, auto const& y){ cout << x << ' ' << y << endl; }, a, b);
+//
+//         a.emplace<0>(1987);
+//         b=tu::tagged_union<char, int, string>('c');
+//         tu::visit([](auto const& x, auto const& y){ cout << x << ' ' << y << endl; }, a, b);
+// }
+//
+// // 16種類のメッセージでstd::variant，std::visitと比較する
+// template<int I>
+// struct Msg{
+//         static constexpr int id=I;
+//         int v;
+// };
+//
+// template<template<typename ...> class V, size_t ... Is>
+// V<Msg<Is>...> msg_variant(index_sequence<Is...>);
+//
+// template<typename V, size_t ... Is>
+// V make_msg(size_t k, int v, index_sequence<Is...>)
+// {
+//         static V (* const table[])(int)={[](int a)->V{ return Msg<static_cast<int>(Is)>{a}; }...};
+//         return table[k](v);
+// }
+//
+// template<typename V, typename Visit>
+// void bench_visit(char const* name, Visit visit, int n)
+// {
+//         vector<V> msgs;
+//         mt19937 gen(1987);
+//         for(int i=0; i<n; ++i){
+//                 msgs.push_back(make_msg<V>(gen()%16, i, make_index_sequence<16>{}));
+//         }
+//
+//         auto start=chrono::steady_clock::now();
+//         long long sum=0;
+//         for(auto const& m: msgs){
+//                 sum+=visit([](auto const& x){ return x.v*(remove_reference_t<decltype(x)>::id+1); }, m);
+//         }
+//         chrono::duration<double, nano> d=chrono::steady_clock::now()-start;
+//         cout << name << ": " << d.count()/n << " ns/visit, sizeof " << sizeof(V) << " (" << sum << ")" << endl;
+// }
+//
+// void bench_visit()
+// {
+//         using V1=decltype(msg_variant<variant>(make_index_sequence<16>{}));
+//         using V2=decltype(msg_variant<tu::tagged_union>(make_index_sequence<16>{}));
+//
+//         bench_visit<V1>("std::variant ", [](auto&& f, V1 const& m){ return visit(f, m); }, 10'000'000);
+//         bench_visit<V2>("tagged_union", [](auto&& f, V2 const& m){ return tu::visit(f, m); }, 10'000'000);
+// }
+
+
+/**
+ * (i/o)stringstreamの使い方を確認したい
+ */
+// char str[]={"1987 hoge 3.14"};
+// int m;
+// char s[10]={};
 // float f;
 //
-// // istringstreamはsscanfに代替するもの
-// // 以下はsscanf(str, "%d %s %f", &m, s, &f)してるのと同じ
-// // 型が一致していないとエラーになる
-// istringstream iss(str);
-// iss >> m;
-// iss >> s;
-// iss >> f;
+// // istringstreamはsscanfに代替するもの
+// // 以下はsscanf(str, "%d %s %f", &m, s, &f)してるのと同じ
+// // 型が一致していないとエラーになる
+// istringstream iss(str);
+// iss >> m;
+// iss >> s;
+// iss >> f;
+//
+// cout << m << '\n';
+// cout << s << '\n';
+// cout << f << endl;
+//
+// // ostringstreamはsprintfに代替するもの
+// // 以下はsprintf(str, "%d %s %f", m, s, f)してるのと同じ
+// ostringstream oss;
+// oss << m << ' ' << s << ' ' << f;
+//
+// cout << oss.str() << endl;
+
+
+/**
+ * "1987 hoge 3.14" 形式のレコードを列ごとに読み込んで集計したい
+ * [charconv],[utility.from.chars]
+ */
+// // 上の例のようにistringstreamで1レコードずつ読み込み，レコードのオブジェクトを作ってから集計すると，
+// // 1値ごとにストリームの状態確認やロケールの処理が入り，さらにレコード毎に文字列を確保することになる
+// // ファイルをブロック単位でバッファに読み込み，そこから直接 int，単語ID，float の列に書き込む
+// // 単語は初出順にIDを振る(intern)ので，単語での集計は連想配列ではなくIDを添字にした配列で行える
+// // 集計は列を先頭から走査するだけなので，コンパイラによるベクトル化が効く
+// struct columns{
+//         vector<int32_t> m;
+//         vector<uint32_t> word;
+//         vector<float> f;
+//
+//         deque<string> words; // ID→単語，伸長しても要素が移動しないのでstring_viewが無効にならない
+//         unordered_map<string_view, uint32_t> ids; // 単語→ID
+//         size_t skipped=0; // 読み飛ばした空行や形式の合わない行の数
+//
+//         // 既出の単語はstring_viewで探すだけなので，文字列の確保は起きない
+//         uint32_t intern(string_view w)
+//         {
+//                 auto it=ids.find(w);
+//                 if(it!=ids.end()){
+//                         return it->second;
+//                 }
+//                 auto id=static_cast<uint32_t>(words.size());
+//                 ids.emplace(words.emplace_back(w), id);
+//                 return id;
+//         }
+// };
+//
+// // [p, eol)の1行を読み込む，空行や形式の合わない行は読み飛ばしてfalseを返す
+// // どの走査もeolで止めるので，壊れた行があっても行の外は読まない
+// bool parse_line(char const* p, char const* eol, columns& cols)
+// {
+//         int32_t m;
+//         auto [q, ec]=from_chars(p, eol, m);
+//         if(ec!=errc{} || q==eol || *q!=' '){
+//                 return false;
+//         }
+//
+//         char const* w=q+1;
+//         auto sp=static_cast<char const*>(memchr(w, ' ', eol-w));
+//         if(!sp || sp==w){
+//                 return false;
+//         }
+//
+//         float f;
+//         auto [r, ec2]=from_chars(sp+1, eol, f);
+//         if(ec2!=errc{} || r!=eol){
+//                 return false;
+//         }
+//
+//         cols.m.push_back(m);
+//         cols.word.push_back(cols.intern(string_view(w, sp-w)));
+//         cols.f.push_back(f);
+//         return true;
+// }
+//
+// // [first, last)の完全な行を全て読み込み，読み終えた位置を返す
+// // 最後の改行以降の不完全な行は次のブロックに持ち越す
+// char const* parse_block(char const* first, char const* last, columns& cols)
+// {
+//         char const* p=first;
+//         while(auto eol=static_cast<char const*>(memchr(p, '\n', last-p))){
+//                 cols.skipped+=!parse_line(p, eol, cols);
+//                 p=eol+1;
+//         }
+//         return p;
+// }
+//
+// // ファイルを開けない，または読み込みに失敗したらfalse
+// bool ingest(char const* path, columns& cols, size_t block_size=1<<20)
+// {
+//         unique_ptr<FILE, int (*)(FILE*)> fp(fopen(path, "rb"), &fclose);
+//         if(!fp){
+//                 return false;
+//         }
+//         vector<char> buf(block_size);
+//         size_t carry=0;
+//         while(size_t n=fread(buf.data()+carry, 1, buf.size()-carry, fp.get())){
+//                 char const* end=buf.data()+carry+n;
+//                 char const* rest=parse_block(buf.data(), end, cols);
+//                 carry=end-rest;
+//                 memmove(buf.data(), rest, carry);
+//                 if(carry==buf.size()){
+//                         buf.resize(buf.size()*2); // 1行がブロックより長い
+//                 }
+//         }
+//         if(carry){
+//                 cols.skipped+=!parse_line(buf.data(), buf.data()+carry, cols); // 最後の行に改行が無い
+//         }
+//         return !ferror(fp.get());
+// }
+//
+// struct summary{
+//         long long sum_m=0;
+//         float min_f=numeric_limits<float>::infinity();
+//         float max_f=-numeric_limits<float>::infinity();
+//         vector<double> sum_f_by_word;
+//         vector<size_t> count_by_word;
+// };
+//
+// summary query(columns const& cols)
+// {
+//         summary s;
+//         size_t const n=cols.m.size();
+//         int32_t const* m=cols.m.data();
+//         float const* f=cols.f.data();
+//         uint32_t const* w=cols.word.data();
+//
+//         for(size_t i=0; i<n; ++i){
+//                 s.sum_m+=m[i];
+//         }
+//         for(size_t i=0; i<n; ++i){
+//                 s.min_f=min(s.min_f, f[i]);
+//                 s.max_f=max(s.max_f, f[i]);
+//         }
+//
+//         // 単語IDは0から詰まっているので，group-byは配列への加算になる
+//         s.sum_f_by_word.assign(cols.words.size(), 0);
+//         s.count_by_word.assign(cols.words.size(), 0);
+//         for(size_t i=0; i<n; ++i){
+//                 s.sum_f_by_word[w[i]]+=f[i];
+//                 ++s.count_by_word[w[i]];
+//         }
+//         return s;
+// }
+//
+// // 比較用の，レコード毎にオブジェクトを作ってから集計する書き方
+// struct record{
+//         int m;
+//         string s;
+//         float f;
+// };
+//
+// void bench_ingest(int n)
+// {
+//         char const* path="records.txt";
+//         {
+//                 ofstream ofs(path);
+//                 char const* words[]={"hoge", "fuga", "foo", "bar"};
+//                 for(int i=0; i<n; ++i){
+//                         ofs << 1987+i%100 << ' ' << words[i%4] << ' ' << 3.14f*(i%10) << '\n';
+//                 }
+//         }
+//
+//         auto t0=chrono::steady_clock::now();
+//         vector<record> recs;
+//         {
+//                 ifstream ifs(path);
+//                 record r;
+//                 while(ifs >> r.m >> r.s >> r.f){
+//                         recs.push_back(r);
+//                 }
+//         }
+//
+//         auto t1=chrono::steady_clock::now();
+//         map<string, double> by_word;
+//         long long sum_m=0;
+//         for(auto const& r: recs){
+//                 sum_m+=r.m;
+//                 by_word[r.s]+=r.f;
+//         }
+//
+//         auto t2=chrono::steady_clock::now();
+//         columns cols;
+//         if(!ingest(path, cols)){
+//                 cout << "cannot read " << path << endl;
+//                 return;
+//         }
+//
+//         auto t3=chrono::steady_clock::now();
+//         summary s=query(cols);
+//
+//         auto t4=chrono::steady_clock::now();
+//         auto rate=[n](auto d){ return n/chrono::duration<double>(d).count()/1e6; };
+//         cout << "records: parse " << rate(t1-t0) << " Mrows/s, query " << rate(t2-t1) << " Mrows/s (" << sum_m << ")" << '\n';
+//         cout << "columns: parse " << rate(t3-t2) << " Mrows/s, query " << rate(t4-t3) << " Mrows/s (" << s.sum_m << ")" << '\n';
+//         for(size_t i=0; i<cols.words.size(); ++i){
+//                 cout << cols.words[i] << ": " << s.count_by_word[i] << ", " << s.sum_f_by_word[i] << " (" << by_word[cols.words[i]] << ")" << '\n';
+//         }
+//         remove(path);
+// }
+
+
+/**
+ * 同じレコードを解析の要らないバイナリ形式でやり取りしたい
+ * [basic.types.general],[intro.object]
+ */
+// // 上の例のように m，s，f を文字列にして書き，読む側で解析し直すと，両側で変換の時間が掛かる
+// // 内部のプロセス間のやり取りでは人が読む必要が無いので，メモリ上の表現をそのままファイルにする
+// // ・ヘッダ，固定長のレコードの並び，文字列領域の順に並べる
+// //   レコードの各フィールドは固定の位置にあり，文字列は文字列領域の中の位置と長さで持つ
+// //   同じ文字列は1回だけ書く
+// // ・ヘッダにスキーマの版とレコードの大きさを持つ
+// //   後の版でレコードの末尾にフィールドを足しても，古い読み手はレコードの大きさずつ進めて知っているフィールドだけを読める
+// // ・読む側は最初に1回だけ検証し(validate)，その後はポインタのキャストと添字の範囲確認だけで読む
+// //   mmapした領域をreinterpret_castでレコードとして読むのは，厳密にはC++23のstart_lifetime_asが必要だが，
+// //   トリビアルにコピー可能な型であれば主要なコンパイラでは期待通りに動く
+// // ・バイト順は書き手のまま(通常はリトルエンディアン)で，ヘッダの0x01020304を書き手のバイト順で書いておき，読み手と異なれば検出する
+// //   マジックナンバーはcharの配列なのでバイト順では変わらず，これでは検出できない
+// namespace rec{
+//         struct header{
+//                 char magic[4]; // "REC\x01"
+//                 uint16_t version;
+//                 uint16_t header_size;
+//                 uint32_t record_size;
+//                 uint32_t byte_order; // byte_order_markを書き手のバイト順で書く
+//                 uint64_t count;
+//                 uint64_t strings_offset;
+//                 uint64_t strings_size;
+//         };
+//
+//         // 版1のレコード，版を上げる時は末尾にだけ追加する
+//         struct record{
+//                 int32_t m;
+//                 float f;
+//                 uint32_t s_offset;
+//                 uint32_t s_size;
+//         };
+//
+//         static_assert(is_trivially_copyable_v<header> && is_trivially_copyable_v<record>);
+//         static_assert(sizeof(header)%alignof(record)==0);
+//
+//         constexpr uint16_t current_version=1;
+//         constexpr uint32_t byte_order_mark=0x01020304;
+//
+//         class writer{
+//                 vector<record> m_records;
+//                 string m_strings;
+//                 unordered_map<string, uint32_t> m_offsets;
+//         public:
+//                 void add(int32_t m, string_view s, float f)
+//                 {
+//                         auto [it, inserted]=m_offsets.try_emplace(string(s), static_cast<uint32_t>(m_strings.size()));
+//                         if(inserted){
+//                                 m_strings+=s;
+//                         }
+//                         m_records.push_back({m, f, it->second, static_cast<uint32_t>(s.size())});
+//                 }
+//
+//                 // ヘッダ，レコード，文字列を1つのバッファにする
+//                 vector<char> finish() const
+//                 {
+//                         header h{{'R', 'E', 'C', '\x01'}, current_version, sizeof(header), sizeof(record), byte_order_mark, m_records.size(), 0, m_strings.size()};
+//                         h.strings_offset=sizeof(header)+m_records.size()*sizeof(record);
+//                         vector<char> out(h.strings_offset+h.strings_size);
+//                         memcpy(out.data(), &h, sizeof(h));
+//                         if(!m_records.empty()){
+//                                 memcpy(out.data()+sizeof(h), m_records.data(), m_records.size()*sizeof(record));
+//                         }
+//                         memcpy(out.data()+h.strings_offset, m_strings.data(), m_strings.size());
+//                         return out;
+//                 }
+//
+//                 bool write(char const* path) const
+//                 {
+//                         vector<char> buf=finish();
+//                         unique_ptr<FILE, int (*)(FILE*)> fp(fopen(path, "wb"), &fclose);
+//                         return fp && fwrite(buf.data(), 1, buf.size(), fp.get())==buf.size() && fclose(fp.release())==0;
+//                 }
+//         };
+//
+//         class view{
+//                 char const* m_base=nullptr;
+//                 size_t m_count=0;
+//                 size_t m_stride=0;
+//                 string_view m_strings;
+//         public:
+//                 // 検証に失敗した場合は空のview(エラーの理由はerrorに入れる)
+//                 static view validate(string_view file, char const** error=nullptr)
+//                 {
+//                         auto fail=[&](char const* why){
+//                                 if(error){
+//                                         *error=why;
+//                                 }
+//                                 return view();
+//                         };
+//                         if(reinterpret_cast<uintptr_t>(file.data())%alignof(header)!=0){
+//                                 return fail("misaligned buffer");
+//                         }
+//                         if(file.size()<sizeof(header)){
+//                                 return fail("truncated header");
+//                         }
+//                         auto h=reinterpret_cast<header const*>(file.data());
+//                         if(memcmp(h->magic, "REC", 3)!=0){
+//                                 return fail("bad magic");
+//                         }
+//                         if(h->magic[3]!='\x01'){
+//                                 return fail("unsupported format");
+//                         }
+//                         if(h->byte_order!=byte_order_mark){
+//                                 return fail(h->byte_order==__builtin_bswap32(byte_order_mark) ? "byte order mismatch" : "bad byte order mark");
+//                         }
+//                         if(h->version<1 || h->header_size<sizeof(header) || h->header_size%alignof(record)!=0
+//                            || h->record_size<sizeof(record) || h->record_size%alignof(record)!=0){
+//                                 return fail("unsupported schema");
+//                         }
+//                         uint64_t records_end=h->header_size+h->count*h->record_size; // 1ファイルは2^64バイトより十分小さい
+//                         if(h->count>file.size()/h->record_size || records_end>h->strings_offset
+//                            || h->strings_offset>file.size() || h->strings_size>file.size()-h->strings_offset){
+//                                 return fail("sections out of range");
+//                         }
+//
+//                         view v;
+//                         v.m_base=file.data()+h->header_size;
+//                         v.m_count=h->count;
+//                         v.m_stride=h->record_size;
+//                         v.m_strings=file.substr(h->strings_offset, h->strings_size);
+//                         for(size_t i=0; i<v.m_count; ++i){
+//                                 record const& r=*v.at(i);
+//                                 if(r.s_offset>v.m_strings.size() || r.s_size>v.m_strings.size()-r.s_offset){
+//                                         return fail("string out of range");
+//                                 }
+//                         }
+//                         return v;
+//                 }
+//
+//                 size_t size() const { return m_count; }
+//
+//                 record const* at(size_t i) const
+//                 {
+//                         return i<m_count ? reinterpret_cast<record const*>(m_base+i*m_stride) : nullptr;
+//                 }
+//
+//                 string_view s(record const& r) const
+//                 {
+//                         return m_strings.substr(r.s_offset, r.s_size); // 検証済み
+//                 }
+//         };
+// }
+//
+// void bench_records(size_t n)
+// {
+//         char const* words[]={"hoge", "fuga", "foo", "bar", "aaaaaaaaaaaaaa"};
+//         mt19937 gen(1987);
+//         vector<tuple<int32_t, string_view, float>> data;
+//         for(size_t i=0; i<n; ++i){
+//                 data.emplace_back(static_cast<int32_t>(gen()%100'000), words[gen()%5], static_cast<float>(gen()%10'000)/100);
+//         }
+//         auto ms=[](auto d){ return chrono::duration<double, milli>(d).count(); };
+//
+//         // テキスト
+//         auto t0=chrono::steady_clock::now();
+//         ostringstream oss;
+//         for(auto const& [m, s, f]: data){
+//                 oss << m << ' ' << s << ' ' << f << '\n';
+//         }
+//         string text=oss.str();
+//         auto t1=chrono::steady_clock::now();
+//         istringstream iss(text);
+//         int32_t m;
+//         string s;
+//         float f;
+//         double text_sum=0;
+//         while(iss >> m >> s >> f){
+//                 text_sum+=m+s.size()+f;
+//         }
+//         auto t2=chrono::steady_clock::now();
+//
+//         // バイナリ
+//         rec::writer w;
+//         for(auto const& [m, s, f]: data){
+//                 w.add(m, s, f);
+//         }
+//         vector<char> bin=w.finish();
+//         auto t3=chrono::steady_clock::now();
+//         rec::view v=rec::view::validate(string_view(bin.data(), bin.size()));
+//         double bin_sum=0;
+//         for(size_t i=0; i<v.size(); ++i){
+//                 rec::record const& r=*v.at(i);
+//                 bin_sum+=r.m+v.s(r).size()+r.f;
+//         }
+//         auto t4=chrono::steady_clock::now();
+//
+//         cout << "text:   encode " << ms(t1-t0) << " ms, decode " << ms(t2-t1) << " ms, " << text.size() << " bytes (" << text_sum << ")" << '\n';
+//         cout << "binary: encode " << ms(t3-t2) << " ms, decode " << ms(t4-t3) << " ms, " << bin.size() << " bytes (" << bin_sum << ")" << endl;
+//
+//         // 壊れたデータは検証で弾かれる
+//         char const* error="";
+//         bin[sizeof(rec::header)+8]='\xff'; // 最初のレコードのs_offset
+//         rec::view::validate(string_view(bin.data(), bin.size()), &error);
+//         cout << "corrupted: " << error << endl;
+// }
+
+
+/**
+ * (i/o)fstream の使い方を確認したい
+ */
+// string str;
+// ifstream ifs("abc.txt");
+// ofstream ofs("def.txt");
+//
+// while(!getline(ifs, str).eof()){
+//         cout << str << endl;
+//         ofs << str << endl;
+// }
+
+
+/**
+ * 1回ごとの処理時間の分布(p99など)を本番でも軽く測りたい
+ * [time.clock.steady],[atomics.order],[basic.stc.thread]
+ */
+// // 上の例の iss >> ... や ofs << str の時間を平均で見ると，たまに起きる長い停止(ページフォルトやflush)が埋もれてしまう
+// // かといって1回ごとにcoutへ時間を出力すると，出力の方が遥かに重く本番では使えない
+// // 値を対数線形のバケット(HDR Histogram)に数えるだけにして，読む時にパーセンタイルを求める
+// // ・2の累乗の区間ごとに64個のバケットに分けるので，どの大きさの値でも相対誤差は1/64以下
+// //   バケットの位置は最上位ビットの位置とシフトだけで求まる
+// // ・バケットはスレッドごとに持ち，書くのはそのスレッドだけなので，lock命令の要らないrelaxedのload/storeで数える
+// //   読む側は全スレッドのバケットを足し合わせる(読んでいる間に数えられた分は含まれなかったり，含まれたりする)
+// // ・スレッドごとの番号はスレッドが終わると次のスレッドに再利用し，数えた値はヒストグラムに残す
+// //   番号が足りない場合は共有のバケットにfetch_addで数える
+// inline size_t thread_slot()
+// {
+//         static mutex mtx;
+//         static vector<size_t> free_slots;
+//         static size_t next=0;
+//         struct holder{
+//                 size_t id;
+//
+//                 holder()
+//                 {
+//                         lock_guard<mutex> lock(mtx);
+//                         if(free_slots.empty()){
+//                                 id=next++;
+//                         }else{
+//                                 id=free_slots.back();
+//                                 free_slots.pop_back();
+//                         }
+//                 }
+//
+//                 ~holder()
+//                 {
+//                         lock_guard<mutex> lock(mtx);
+//                         free_slots.push_back(id);
+//                 }
+//         };
+//         thread_local holder h;
+//         return h.id;
+// }
+//
+// class latency_histogram{
+// public:
+//         static constexpr int sub_bits=6;
+//         static constexpr int max_shift=34; // 2^41ns(約37分)以上は最後のバケットに数える
+//         static constexpr size_t bucket_count=size_t(max_shift+2)<<sub_bits;
+//         static constexpr uint64_t max_value=(uint64_t(1)<<(max_shift+sub_bits+1))-1;
+//         static constexpr size_t max_threads=256;
+//
+//         static size_t index(uint64_t v)
+//         {
+//                 v=min(v, max_value);
+//                 int e=max(0, 63-__builtin_clzll(v|1)-sub_bits);
+//                 return (size_t(e)<<sub_bits)+(v>>e);
+//         }
+//
+//         // バケットiに入る最大の値
+//         static uint64_t highest_equivalent(size_t i)
+//         {
+//                 size_t e=i>>sub_bits;
+//                 if(e<=1){
+//                         return i;
+//                 }
+//                 --e;
+//                 return ((i-(e<<sub_bits)+1)<<e)-1;
+//         }
+//
+//         struct snapshot{
+//                 vector<uint64_t> counts=vector<uint64_t>(bucket_count);
+//                 uint64_t total=0;
+//                 uint64_t max=0;
+//
+//                 // 値の小さい方から割合p(0〜1)の位置にある値，バケットの上端を返すので実際の値以上になる
+//                 uint64_t percentile(double p) const
+//                 {
+//                         if(total==0){
+//                                 return 0;
+//                         }
+//                         auto rank=std::max<uint64_t>(1, static_cast<uint64_t>(ceil(p*total)));
+//                         uint64_t seen=0;
+//                         for(size_t i=0; i<bucket_count; ++i){
+//                                 seen+=counts[i];
+//                                 if(seen>=rank){
+//                                         return std::min(highest_equivalent(i), max);
+//                                 }
+//                         }
+//                         return max;
+//                 }
+//         };
+// private:
+//         struct shard{
+//                 atomic<uint64_t> counts[bucket_count]{};
+//                 atomic<uint64_t> max{0};
+//         };
+//
+//         array<atomic<shard*>, max_threads+1> m_shards{}; // 最後は番号が足りないスレッドの共有
+//
+//         shard& get(size_t slot)
+//         {
+//                 shard* s=m_shards[slot].load(memory_order_acquire);
+//                 if(!s){
+//                         auto fresh=new shard;
+//                         if(m_shards[slot].compare_exchange_strong(s, fresh, memory_order_acq_rel)){
+//                                 s=fresh;
+//                         }else{
+//                                 delete fresh; // 共有のバケットを他のスレッドが先に作った
+//                         }
+//                 }
+//                 return *s;
+//         }
+// public:
+//         latency_histogram()=default;
+//         latency_histogram(latency_histogram const&)=delete;
+//         latency_histogram& operator=(latency_histogram const&)=delete;
+//
+//         ~latency_histogram()
+//         {
+//                 for(auto& s: m_shards){
+//                         delete s.load();
+//                 }
+//         }
+//
+//         void record(uint64_t ns)
+//         {
+//                 size_t const i=index(ns);
+//                 size_t const slot=thread_slot();
+//                 if(slot<max_threads){
+//                         shard& s=get(slot);
+//                         s.counts[i].store(s.counts[i].load(memory_order_relaxed)+1, memory_order_relaxed);
+//                         if(ns>s.max.load(memory_order_relaxed)){
+//                                 s.max.store(ns, memory_order_relaxed);
+//                         }
+//                 }else{
+//                         shard& s=get(max_threads);
+//                         s.counts[i].fetch_add(1, memory_order_relaxed);
+//                         for(uint64_t m=s.max.load(memory_order_relaxed); ns>m && !s.max.compare_exchange_weak(m, ns, memory_order_relaxed); ){
+//                         }
+//                 }
+//         }
+//
+//         snapshot read() const
+//         {
+//                 snapshot r;
+//                 for(auto const& p: m_shards){
+//                         shard const* s=p.load(memory_order_acquire);
+//                         if(!s){
+//                                 continue;
+//                         }
+//                         for(size_t i=0; i<bucket_count; ++i){
+//                                 uint64_t c=s->counts[i].load(memory_order_relaxed);
+//                                 r.counts[i]+=c;
+//                                 r.total+=c;
+//                         }
+//                         r.max=std::max(r.max, s->max.load(memory_order_relaxed));
+//                 }
+//                 return r;
+//         }
+// };
+//
+// ostream& operator<<(ostream& os, latency_histogram::snapshot const& s)
+// {
+//         return os << "n " << s.total << ", p50 " << s.percentile(0.5) << " ns, p99 " << s.percentile(0.99)
+//                   << " ns, p999 " << s.percentile(0.999) << " ns, max " << s.max << " ns";
+// }
+//
+// // スコープを抜けるまでの時間を数える
+// class latency_timer{
+//         latency_histogram& m_histogram;
+//         chrono::steady_clock::time_point m_start=chrono::steady_clock::now();
+// public:
+//         explicit latency_timer(latency_histogram& h):m_histogram{h}{}
+//         latency_timer(latency_timer const&)=delete;
+//         latency_timer& operator=(latency_timer const&)=delete;
+//
+//         ~latency_timer()
+//         {
+//                 m_histogram.record(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now()-m_start).count());
+//         }
+// };
+//
+// // 本番ではグローバルに置いておき，監視から定期的にread()する
+// latency_histogram parse_latency;
+// latency_histogram write_latency;
+//
+// // "1987 hoge 3.14"のレコードを複数スレッドで1つずつ読み，読んだ行をファイルに書く
+// void bench_latency(size_t records, int threads)
+// {
+//         string text;
+//         for(size_t i=0; i<records; ++i){
+//                 text+=to_string(i%100'000)+" hoge "+to_string(i%1000)+".14\n";
+//         }
+//
+//         auto parse=[&](bool timed){
+//                 istringstream iss(text);
+//                 int m;
+//                 string s;
+//                 float f;
+//                 double sum=0;
+//                 for(;;){
+//                         if(timed){
+//                                 latency_timer t(parse_latency);
+//                                 if(!(iss >> m >> s >> f)){
+//                                         break;
+//                                 }
+//                         }else if(!(iss >> m >> s >> f)){
+//                                 break;
+//                         }
+//                         sum+=m+f;
+//                 }
+//                 return sum;
+//         };
+//
+//         for(bool timed: {false, true}){
+//                 auto start=chrono::steady_clock::now();
+//                 vector<thread> workers;
+//                 for(int i=0; i<threads; ++i){
+//                         workers.emplace_back(parse, timed);
+//                 }
+//                 for(auto& t: workers){
+//                         t.join();
+//                 }
+//                 chrono::duration<double, milli> d=chrono::steady_clock::now()-start;
+//                 cout << (timed ? "parse timed:   " : "parse untimed: ") << d.count() << " ms" << '\n';
+//         }
+//         cout << "  " << parse_latency.read() << '\n';
+//
+//         istringstream lines(text);
+//         ofstream ofs("def.txt");
+//         string str;
+//         while(getline(lines, str)){
+//                 latency_timer t(write_latency);
+//                 ofs << str << '\n';
+//         }
+//         ofs.close();
+//         cout << "write: " << write_latency.read() << endl;
+// }
+
+
+/**
+ * 複数スレッドの処理の流れをタイムライン(Chromeのトレース形式)で見たい
+ * [basic.stc.thread],[atomics.order],[support.start.term]
+ */
+// // 上のヒストグラムで遅い処理があることは分かっても，パイプラインのどの段でどのスレッドが待っているかは分からない
+// // スコープの始まりと終わりの時刻をイベントとして記録し，chrome://tracing や Perfetto で読めるJSONに書き出す
+// // ・時刻はrdtsc(x86_64)で取る，steady_clock::nowより軽い
+// //   開始時にsteady_clockと比べて1マイクロ秒あたりのカウント数を求めておく(invariant TSCが前提)
+// // ・イベントはスレッドごとのリングバッファ(書き手と読み手が1つずつ)に入れるので，記録する側はロックを取らない
+// //   一杯の時は捨てて数を数える，始まりを捨てたスコープは終わりも記録しない
+// // ・書き出し用のスレッドが10msごとにリングバッファを空にしてファイルに追記する
+// //   stop()かプログラムの終了時(atexit)に残りを書き出してJSONを閉じる
+// // ・記録していない間のscopeはフラグを1つ読むだけ
+// // ・イベント名は文字列リテラルのポインタをそのまま持つ
+// namespace trace{
+//         inline uint64_t now_ticks()
+//         {
+// #ifdef __x86_64__
+//                 return __rdtsc();
+// #else
+//                 return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+// #endif
+//         }
+//
+//         struct event{
+//                 char const* name;
+//                 uint64_t ticks;
+//                 char phase; // 'B'か'E'
+//         };
+//
+//         class ring{
+//                 static constexpr size_t capacity=1<<14;
+//                 unique_ptr<event[]> m_events{new event[capacity]};
+//                 alignas(64) atomic<size_t> m_head{0}; // 書き手だけが進める
+//                 alignas(64) atomic<size_t> m_tail{0}; // 読み手だけが進める
+//                 atomic<uint64_t> m_dropped{0};
+//                 atomic<bool> m_closed{false};
+//         public:
+//                 uint32_t const tid=static_cast<uint32_t>(syscall(SYS_gettid));
+//
+//                 bool push(event e)
+//                 {
+//                         size_t h=m_head.load(memory_order_relaxed);
+//                         if(h-m_tail.load(memory_order_acquire)==capacity){
+//                                 m_dropped.fetch_add(1, memory_order_relaxed);
+//                                 return false;
+//                         }
+//                         m_events[h&(capacity-1)]=e;
+//                         m_head.store(h+1, memory_order_release);
+//                         return true;
+//                 }
+//
+//                 template<typename F>
+//                 void drain(F f)
+//                 {
+//                         size_t t=m_tail.load(memory_order_relaxed);
+//                         for(size_t h=m_head.load(memory_order_acquire); t!=h; ++t){
+//                                 f(m_events[t&(capacity-1)]);
+//                         }
+//                         m_tail.store(t, memory_order_release);
+//                 }
+//
+//                 uint64_t take_dropped() { return m_dropped.exchange(0, memory_order_relaxed); }
+//                 bool closed() const { return m_closed.load(memory_order_acquire); }
+//                 void close() { m_closed.store(true, memory_order_release); }
+//         };
+//
+//         inline atomic<bool> enabled{false};
+//
+//         class session{
+//                 mutex m_mutex; // m_ringsとファイル，リングバッファの読み手はこれを持つスレッドだけ
+//                 vector<shared_ptr<ring>> m_rings;
+//                 FILE* m_out=nullptr;
+//                 bool m_first=true;
+//                 uint64_t m_origin=0;
+//                 double m_ticks_per_us=1000;
+//                 uint64_t m_dropped=0;
+//                 thread m_thread;
+//                 condition_variable m_cv;
+//                 bool m_stop=false;
+//
+//                 void write(uint32_t tid, event const& e)
+//                 {
+//                         fputs(m_first ? "\n" : ",\n", m_out);
+//                         m_first=false;
+//                         fputs("{\"name\":\"", m_out);
+//                         for(char const* p=e.name; *p; ++p){
+//                                 if(*p=='"' || *p=='\\'){
+//                                         fputc('\\', m_out);
+//                                 }
+//                                 fputc(*p, m_out);
+//                         }
+//                         double us=e.ticks>=m_origin ? (e.ticks-m_origin)/m_ticks_per_us : 0;
+//                         fprintf(m_out, "\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u}", e.phase, us, static_cast<int>(getpid()), tid);
+//                 }
+//
+//                 // m_mutexを持って呼ぶ
+//                 void drain_all()
+//                 {
+//                         for(auto it=m_rings.begin(); it!=m_rings.end(); ){
+//                                 ring& r=**it;
+//                                 bool closed=r.closed(); // 先に見ておけば，終わったスレッドのイベントは全て読める
+//                                 r.drain([&](event const& e){ write(r.tid, e); });
+//                                 if(closed){
+//                                         m_dropped+=r.take_dropped();
+//                                         it=m_rings.erase(it);
+//                                 }else{
+//                                         ++it;
+//                                 }
+//                         }
+//                 }
+//
+//                 session()=default;
+//         public:
+//                 static session& instance()
+//                 {
+//                         static session s;
+//                         return s;
+//                 }
+//
+//                 ~session()
+//                 {
+//                         stop();
+//                 }
+//
+//                 void add(shared_ptr<ring> r)
+//                 {
+//                         lock_guard<mutex> lock(m_mutex);
+//                         m_rings.push_back(move(r));
+//                 }
+//
+//                 bool start(char const* path)
+//                 {
+//                         lock_guard<mutex> lock(m_mutex);
+//                         if(m_out || !(m_out=fopen(path, "w"))){
+//                                 return false;
+//                         }
+//                         static bool hooked=(atexit([]{ instance().stop(); }), true);
+//                         (void)hooked;
+//
+//                         auto s0=chrono::steady_clock::now();
+//                         uint64_t t0=now_ticks();
+//                         this_thread::sleep_for(chrono::milliseconds(20));
+//                         chrono::duration<double, micro> d=chrono::steady_clock::now()-s0;
+//                         m_ticks_per_us=(now_ticks()-t0)/d.count();
+//                         m_origin=now_ticks();
+//
+//                         fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", m_out);
+//                         for(auto const& r: m_rings){
+//                                 r->drain([](event const&){}); // 前回止めた後に入ったイベント
+//                                 r->take_dropped();
+//                         }
+//                         m_first=true;
+//                         m_dropped=0;
+//                         m_stop=false;
+//                         m_thread=thread([this]{
+//                                 unique_lock<mutex> lock(m_mutex);
+//                                 while(!m_cv.wait_for(lock, chrono::milliseconds(10), [this]{ return m_stop; })){
+//                                         drain_all();
+//                                 }
+//                         });
+//                         enabled.store(true, memory_order_release);
+//                         return true;
+//                 }
+//
+//                 // 止めた後に閉じられるスコープの終わりは記録されない(ビューアがトレースの終わりまで伸ばして表示する)
+//                 void stop()
+//                 {
+//                         enabled.store(false, memory_order_release);
+//                         {
+//                                 lock_guard<mutex> lock(m_mutex);
+//                                 if(!m_out){
+//                                         return;
+//                                 }
+//                                 m_stop=true;
+//                         }
+//                         m_cv.notify_one();
+//                         m_thread.join();
+//
+//                         lock_guard<mutex> lock(m_mutex);
+//                         drain_all();
+//                         for(auto const& r: m_rings){
+//                                 m_dropped+=r->take_dropped();
+//                         }
+//                         fprintf(m_out, "\n],\"otherData\":{\"dropped\":%llu}}\n", static_cast<unsigned long long>(m_dropped));
+//                         fclose(m_out);
+//                         m_out=nullptr;
+//                 }
+//         };
+//
+//         // スレッドの最初の記録で作って登録し，スレッドの終わりに閉じる(残りは書き出し用のスレッドが読んでから捨てる)
+//         inline ring* local_ring()
+//         {
+//                 struct holder{
+//                         shared_ptr<ring> r=make_shared<ring>();
+//
+//                         holder()
+//                         {
+//                                 session::instance().add(r);
+//                         }
+//
+//                         ~holder()
+//                         {
+//                                 r->close();
+//                         }
+//                 };
+//                 thread_local holder h;
+//                 return h.r.get();
+//         }
+//
+//         class scope{
+//                 ring* m_ring=nullptr;
+//                 char const* m_name;
+//         public:
+//                 explicit scope(char const* name):m_name{name}
+//                 {
+//                         if(enabled.load(memory_order_relaxed)){
+//                                 ring* r=local_ring();
+//                                 m_ring=r->push({name, now_ticks(), 'B'}) ? r : nullptr;
+//                         }
+//                 }
+//
+//                 scope(scope const&)=delete;
+//                 scope& operator=(scope const&)=delete;
+//
+//                 ~scope()
+//                 {
+//                         if(m_ring && enabled.load(memory_order_relaxed)){
+//                                 m_ring->push({m_name, now_ticks(), 'E'});
+//                         }
+//                 }
+//         };
+//
+//         inline bool start(char const* path)
+//         {
+//                 return session::instance().start(path);
+//         }
+//
+//         inline void stop()
+//         {
+//                 session::instance().stop();
+//         }
+// }
+//
+// // ベンチマークの例をスコープで囲んで記録する
+// // この節より前のベンチマークはtraceより前に定義されていて中でスコープを作れないので，ここで1つずつ丸ごと囲む
+// // そのためbench_memoのように中でスレッドを作るものも，呼び出したスレッドの1つのスコープとしてしか見えない
+// // この後の節の複数スレッドで動く処理(単語の数え上げ，外部ソートのラン作成とマージ，steal_poolのタスクとpar_*，
+// // ws_schedulerのタスク，line_followerの読み込みと待ち，lz::writerの圧縮と書き込み)や，sso_stringのベンチマークは，
+// // 中でスコープを作っているので，trace::start()の後に呼べば同じファイルに記録される
+// void bench_trace()
+// {
+//         // 書き出しの間隔(10ms)の間にリングバッファが溢れない程度の回数で測る
+//         auto overhead=[](char const* label){
+//                 auto start=chrono::steady_clock::now();
+//                 for(int i=0; i<5000; ++i){
+//                         trace::scope s("empty");
+//                 }
+//                 cout << label << chrono::duration<double, nano>(chrono::steady_clock::now()-start).count()/5000 << " ns/scope" << endl;
+//         };
+//         overhead("disabled: ");
+//
+//         auto traced=[](char const* name, auto f){
+//                 trace::scope s(name);
+//                 f();
+//         };
+//         trace::start("trace.json");
+//         traced("overhead", [&]{ overhead("enabled:  "); });
+//         traced("bench_pimpl", []{ bench_pimpl(); });
+//         traced("bench_memo", []{ bench_memo(); });
+//         traced("bench_conversion", []{ bench_conversion(); });
+//         traced("bench_singleton", []{ bench_singleton(); });
+//         traced("bench_convert", []{ bench_convert(); });
+//         traced("bench_arena", []{ bench_arena(100'000); });
+//         traced("bench_soa", []{ bench_soa(); });
+//         traced("bench_visit", []{ bench_visit(); });
+//         traced("bench_ingest", []{ bench_ingest(1'000'000); });
+//         traced("bench_records", []{ bench_records(1'000'000); });
+//         traced("bench_latency", []{ bench_latency(100'000, 2); });
+//         trace::stop();
+// }
+
+
+/**
+ * 単語の出現回数を複数スレッドで数えるハッシュ表を作りたい
+ * [unord.req],[thread.mutex]
+ */
+// // 上の例を大きなテキストに広げて，sample.txtのような単語の出現回数を全コアで数える
+// // unordered_map を1つのmutexで保護すると，全スレッドが同じロックを取り合うのでスレッドを増やしても速くならない
+// // ・ハッシュ値の上位ビットで表を分割(シャード)し，シャード毎にロックを持つ
+// //   異なるシャードへの追加は並行に動く
+// // ・各シャードはオープンアドレス法の表にする(Swiss table)
+// //   スロット毎に1バイトの制御バイト(空なら-128，使用中ならハッシュ値の下位7ビット)を持ち，
+// //   16個の制御バイトをSSE2の1命令で比較して，候補のスロットだけ文字列を比較する
+// // ・探索はstring_viewで行い，文字列を確保するのは初めて現れた単語を追加する時だけにする
+// class swiss_counter{
+//         static constexpr int8_t empty=-128;
+//         static constexpr size_t group=16;
+//
+//         struct slot{
+//                 string key;
+//                 size_t count;
+//                 size_t hash;
+//         };
+//
+//         vector<int8_t> m_ctrl; // 末尾のgroupバイトは先頭のコピー，表の終わりを跨ぐグループも1回で読める
+//         vector<slot> m_slots;
+//         size_t m_mask;
+//         size_t m_size=0;
+//
+//         // グループ内で制御バイトがvに等しい位置のビットマスク
+//         static uint32_t match(int8_t const* g, int8_t v)
+//         {
+// #ifdef __SSE2__
+//                 __m128i ctrl=_mm_loadu_si128(reinterpret_cast<__m128i const*>(g));
+//                 return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(v))));
+// #else
+//                 uint32_t m=0;
+//                 for(size_t i=0; i<group; ++i){
+//                         m|=static_cast<uint32_t>(g[i]==v)<<i;
+//                 }
+//                 return m;
+// #endif
+//         }
+//
+//         void set_ctrl(size_t i, int8_t v)
+//         {
+//                 m_ctrl[i]=v;
+//                 if(i<group){
+//                         m_ctrl[m_mask+1+i]=v;
+//                 }
+//         }
+//
+//         // 空きを探して追加する，既に存在しないことがわかっている場合に使う
+//         void insert_new(slot&& s)
+//         {
+//                 for(size_t pos=(s.hash>>7)&m_mask;; pos=(pos+group)&m_mask){
+//                         if(uint32_t e=match(&m_ctrl[pos], empty)){
+//                                 size_t i=(pos+__builtin_ctz(e))&m_mask;
+//                                 set_ctrl(i, static_cast<int8_t>(s.hash&0x7f));
+//                                 m_slots[i]=move(s);
+//                                 ++m_size;
+//                                 return;
+//                         }
+//                 }
+//         }
+//
+//         void rehash()
+//         {
+//                 swiss_counter bigger(2*(m_mask+1));
+//                 for(size_t i=0; i<=m_mask; ++i){
+//                         if(m_ctrl[i]!=empty){
+//                                 bigger.insert_new(move(m_slots[i]));
+//                         }
+//                 }
+//                 *this=move(bigger);
+//         }
+// public:
+//         explicit swiss_counter(size_t capacity=group):m_ctrl(capacity+group, empty), m_slots(capacity), m_mask{capacity-1}{}
+//
+//         void add(string_view key, size_t hash, size_t n=1)
+//         {
+//                 if((m_size+1)*8>(m_mask+1)*7){ // 負荷率を7/8以下に保つ
+//                         rehash();
+//                 }
+//
+//                 auto h2=static_cast<int8_t>(hash&0x7f);
+//                 for(size_t pos=(hash>>7)&m_mask;; pos=(pos+group)&m_mask){
+//                         int8_t const* g=&m_ctrl[pos];
+//                         for(uint32_t m=match(g, h2); m; m&=m-1){
+//                                 slot& s=m_slots[(pos+__builtin_ctz(m))&m_mask];
+//                                 if(s.key==key){
+//                                         s.count+=n;
+//                                         return;
+//                                 }
+//                         }
+//                         // 削除が無いので，グループ内に空きがあればその先に同じキーは無い
+//                         if(match(g, empty)){
+//                                 insert_new({string(key), n, hash});
+//                                 return;
+//                         }
+//                 }
+//         }
+//
+//         template<typename F>
+//         void for_each(F f) const
+//         {
+//                 for(size_t i=0; i<=m_mask; ++i){
+//                         if(m_ctrl[i]!=empty){
+//                                 f(string_view(m_slots[i].key), m_slots[i].count);
+//                         }
+//                 }
+//         }
+// };
+//
+// class concurrent_counter{
+//         static constexpr unsigned shard_bits=6;
+//
+//         struct alignas(64) shard{ // 隣のシャードのロックと同じキャッシュラインに載らないようにする
+//                 mutex mtx;
+//                 swiss_counter table;
+//         };
+//
+//         unique_ptr<shard[]> m_shards{new shard[1<<shard_bits]};
+// public:
+//         void add(string_view word, size_t n=1)
+//         {
+//                 size_t h=hash<string_view>{}(word);
+//                 shard& s=m_shards[h>>(64-shard_bits)];
+//                 lock_guard<mutex> lock(s.mtx);
+//                 s.table.add(word, h, n);
+//         }
+//
+//         template<typename F>
+//         void for_each(F f)
+//         {
+//                 for(size_t i=0; i<(1<<shard_bits); ++i){
+//                         lock_guard<mutex> lock(m_shards[i].mtx);
+//                         m_shards[i].table.for_each(f);
+//                 }
+//         }
+// };
+//
+// // 比較用の，1つのmutexで保護したunordered_map
+// class locked_counter{
+//         mutex m_mtx;
+//         unordered_map<string, size_t> m_map;
+// public:
+//         void add(string_view word, size_t n=1)
+//         {
+//                 lock_guard<mutex> lock(m_mtx);
+//                 m_map[string(word)]+=n;
+//         }
+//
+//         template<typename F>
+//         void for_each(F f)
+//         {
+//                 for(auto const& [w, c]: m_map){
+//                         f(string_view(w), c);
+//                 }
+//         }
+// };
+//
+// // テキストをスレッド数で分割し，各スレッドは空白で区切った単語を数える
+// // 分割位置は空白まで進めて，単語が2つのスレッドに分かれないようにする
+// template<typename Counter>
+// double count_words(string const& text, unsigned threads, Counter& counter)
+// {
+//         auto is_space=[](char c){ return c==' ' || c=='\n' || c=='\t' || c=='\r'; };
+//         vector<size_t> cuts{0};
+//         for(unsigned t=1; t<threads; ++t){
+//                 size_t p=max(cuts.back(), text.size()*t/threads);
+//                 while(p<text.size() && !is_space(text[p])){
+//                         ++p;
+//                 }
+//                 cuts.push_back(p);
+//         }
+//         cuts.push_back(text.size());
+//
+//         atomic<size_t> tokens{0};
+//         auto start=chrono::steady_clock::now();
+//         vector<thread> ts;
+//         for(unsigned t=0; t<threads; ++t){
+//                 ts.emplace_back([&, t]{
+//                         trace::scope scope("count words");
+//                         char const* p=text.data()+cuts[t];
+//                         char const* end=text.data()+cuts[t+1];
+//                         size_t n=0;
+//                         while(p<end){
+//                                 while(p<end && is_space(*p)){
+//                                         ++p;
+//                                 }
+//                                 char const* w=p;
+//                                 while(p<end && !is_space(*p)){
+//                                         ++p;
+//                                 }
+//                                 if(p>w){
+//                                         counter.add(string_view(w, p-w));
+//                                         ++n;
+//                                 }
+//                         }
+//                         tokens+=n;
+//                 });
+//         }
+//         for(auto& t: ts){
+//                 t.join();
+//         }
+//         chrono::duration<double> d=chrono::steady_clock::now()-start;
+//         return tokens/d.count()/1e6;
+// }
+//
+// void bench_word_count(size_t mega_bytes)
+// {
+//         ifstream ifs("sample.txt");
+//         string sample((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+//         string text;
+//         for(size_t i=0; text.size()<mega_bytes<<20; ++i){
+//                 text+=sample;
+//                 text+=to_string(i%100'000); // 語彙を増やす
+//                 text+='\n';
+//         }
+//
+//         for(unsigned threads=1; threads<=thread::hardware_concurrency(); threads*=2){
+//                 concurrent_counter c1;
+//                 locked_counter c2;
+//                 double r1=count_words(text, threads, c1);
+//                 double r2=count_words(text, threads, c2);
+//                 cout << threads << " threads: sharded swiss " << r1 << " Mtokens/s, locked unordered_map " << r2 << " Mtokens/s" << '\n';
+//
+//                 if(threads==1){
+//                         c1.for_each([](string_view w, size_t n){
+//                                 if(n>100'000){
+//                                         cout << "  " << w << ": " << n << '\n';
+//                                 }
+//                         });
+//                 }
+//         }
+// }
+
+
+/**
+ * メモリに収まらないテキストファイルを行単位でソートしたい
+ * [alg.sort],[alg.merge],[futures.task]
+ */
+// // abc.txtの行をソートしてdef.txtに書き出したいが，ファイルがメモリより大きい場合は全行を読み込めない
+// // 外部マージソートは次の2段階で行う
+// // 1. メモリ予算分ずつ読み込み，複数スレッドでソートして一時ファイル(ラン)に書き出す
+// // 2. ランを先頭から同時に読み，k-wayマージで1つのファイルにする
+// //    同時に開くランの数(k)はメモリ予算で決まる上限までにし，ランが多ければマージしたランをさらにマージする(多段マージ)
+// // k-wayマージで最小の行を選ぶのに敗者木(loser tree)を使う
+// // 各内部ノードに「そこで負けた方」を持たせておくと，勝者を取り出した後は葉から根まで1回辿るだけで次の勝者が決まる
+// // 比較回数は1行あたりlog2(k)回で，ヒープのように子同士を比較する必要が無い
+// // ランの読み込みは2つのバッファを交互に使い，一方を処理している間にもう一方へ次のブロックを読んでおく(先読み)
+// // 先読みはマージ1回につき1つのスレッドがまとめて行う，読み込みのたびにスレッドを作ると小さいバッファではその方が重い
+// class prefetcher{
+//         mutex m_mutex;
+//         condition_variable m_cv;
+//         deque<packaged_task<size_t()>> m_tasks;
+//         bool m_stop=false;
+//         thread m_thread{[this]{
+//                 for(;;){
+//                         packaged_task<size_t()> task;
+//                         {
+//                                 unique_lock<mutex> lock(m_mutex);
+//                                 m_cv.wait(lock, [this]{ return m_stop || !m_tasks.empty(); });
+//                                 if(m_tasks.empty()){
+//                                         return;
+//                                 }
+//                                 task=move(m_tasks.front());
+//                                 m_tasks.pop_front();
+//                         }
+//                         task();
+//                 }
+//         }};
+// public:
+//         prefetcher()=default;
+//         prefetcher(prefetcher const&)=delete;
+//         prefetcher& operator=(prefetcher const&)=delete;
+//
+//         // 残っている読み込みを全て終えてから止まる
+//         ~prefetcher()
+//         {
+//                 {
+//                         lock_guard<mutex> lock(m_mutex);
+//                         m_stop=true;
+//                 }
+//                 m_cv.notify_one();
+//                 m_thread.join();
+//         }
+//
+//         template<typename F>
+//         future<size_t> submit(F f)
+//         {
+//                 packaged_task<size_t()> task(move(f));
+//                 auto result=task.get_future();
+//                 {
+//                         lock_guard<mutex> lock(m_mutex);
+//                         m_tasks.push_back(move(task));
+//                 }
+//                 m_cv.notify_one();
+//                 return result;
+//         }
+// };
+//
+// class run_reader{
+//         prefetcher& m_prefetcher;
+//         unique_ptr<FILE, int (*)(FILE*)> m_fp;
+//         vector<char> m_buf, m_next;
+//         size_t m_pos=0, m_len=0;
+//         future<size_t> m_pending;
+//         string m_line;
+//         bool m_error=false;
+//
+//         void prefetch()
+//         {
+//                 m_pending=m_prefetcher.submit([this]{
+//                         trace::scope s("prefetch run");
+//                         return fread(m_next.data(), 1, m_next.size(), m_fp.get());
+//                 });
+//         }
+//
+//         bool refill()
+//         {
+//                 if(!m_pending.valid()){
+//                         return false;
+//                 }
+//                 m_len=m_pending.get();
+//                 if(m_len==0){
+//                         m_error=ferror(m_fp.get())!=0;
+//                         return false;
+//                 }
+//                 m_buf.swap(m_next);
+//                 m_pos=0;
+//                 prefetch();
+//                 return true;
+//         }
+// public:
+//         run_reader(char const* path, size_t buffer_size, prefetcher& pf)
+//                 :m_prefetcher{pf}, m_fp{fopen(path, "rb"), &fclose}, m_buf(buffer_size), m_next(buffer_size)
+//         {
+//                 m_error=!m_fp;
+//                 if(m_fp){
+//                         prefetch();
+//                 }
+//         }
+//
+//         run_reader(run_reader const&)=delete;
+//         run_reader& operator=(run_reader const&)=delete;
+//
+//         ~run_reader()
+//         {
+//                 if(m_pending.valid()){
+//                         m_pending.wait();
+//                 }
+//         }
+//
+//         // 開けなかったか，読み込みに失敗した
+//         bool error() const
+//         {
+//                 return m_error;
+//         }
+//
+//         // 次の行をline()に読み込む，ファイルの終わりならfalseを返す
+//         bool next()
+//         {
+//                 m_line.clear();
+//                 for(;;){
+//                         if(m_pos==m_len && !refill()){
+//                                 return !m_line.empty();
+//                         }
+//                         char const* p=m_buf.data()+m_pos;
+//                         auto nl=static_cast<char const*>(memchr(p, '\n', m_len-m_pos));
+//                         if(nl){
+//                                 m_line.append(p, nl);
+//                                 m_pos=nl-m_buf.data()+1;
+//                                 return true;
+//                         }
+//                         m_line.append(p, m_len-m_pos); // 行がブロックを跨いでいる
+//                         m_pos=m_len;
+//                 }
+//         }
+//
+//         string const& line() const
+//         {
+//                 return m_line;
+//         }
+// };
+//
+// class loser_tree{
+//         vector<unique_ptr<run_reader>>& m_runs;
+//         vector<bool> m_done;
+//         vector<size_t> m_tree; // m_tree[0]が勝者，それ以外は内部ノードで負けた方
+//         size_t m_k;
+//
+//         // aがbに勝つ(小さい)か，m_kは初期化用の番兵で常に勝つ
+//         bool beats(size_t a, size_t b) const
+//         {
+//                 if(a==m_k || b==m_k){
+//                         return a==m_k;
+//                 }
+//                 if(m_done[a] || m_done[b]){
+//                         return !m_done[a];
+//                 }
+//                 return m_runs[a]->line()<m_runs[b]->line();
+//         }
+//
+//         // 葉sから根まで辿り，勝った方を上に進める
+//         void adjust(size_t s)
+//         {
+//                 for(size_t t=(s+m_k)/2; t>0; t/=2){
+//                         if(beats(m_tree[t], s)){
+//                                 swap(s, m_tree[t]);
+//                         }
+//                 }
+//                 m_tree[0]=s;
+//         }
+// public:
+//         explicit loser_tree(vector<unique_ptr<run_reader>>& runs):m_runs{runs}, m_done(runs.size()), m_tree(runs.size(), runs.size()), m_k{runs.size()}
+//         {
+//                 for(size_t s=m_k; s-->0;){
+//                         m_done[s]=!m_runs[s]->next();
+//                         adjust(s);
+//                 }
+//         }
+//
+//         // 最小の行を持つラン，全て読み終えたらnullptr
+//         run_reader* top() const
+//         {
+//                 return m_k && !m_done[m_tree[0]] ? m_runs[m_tree[0]].get() : nullptr;
+//         }
+//
+//         void pop()
+//         {
+//                 size_t s=m_tree[0];
+//                 m_done[s]=!m_runs[s]->next();
+//                 adjust(s);
+//         }
+// };
+//
+// // 1. ランの作成，budgetバイトずつ読み込み，threads個に分けて並列にソートしてから並列にマージし，1つのランとして書き出す
+// // 行の索引もbudgetに含める，1/5を索引(1行8バイト，inplace_mergeの一時バッファが最大でその半分)，残りをテキストに使い，
+// // どちらかが一杯になったらそこで1つのランにする(平均48バイトより短い行ばかりなら索引が先に一杯になり，ランが小さくなる)
+// // 1行がテキストの領域より長い場合だけは，その行が収まるまでバッファを広げ，書き出したら元の大きさに戻す
+// // 作ったランのパスをrunsに追加する，読み書きに失敗したらfalse
+// bool make_runs(char const* in, char const* out, size_t budget, unsigned threads, vector<string>& runs)
+// {
+//         struct line_ref{
+//                 uint32_t begin, size; // string_viewの半分の大きさで済ませる
+//         };
+//         size_t const max_lines=max<size_t>(budget/5/(sizeof(line_ref)*3/2), 1);
+//         size_t const text_size=min<size_t>(max<size_t>(budget-max_lines*sizeof(line_ref), 1), numeric_limits<uint32_t>::max());
+//
+//         unique_ptr<FILE, int (*)(FILE*)> fp(fopen(in, "rb"), &fclose);
+//         if(!fp){
+//                 return false;
+//         }
+//         vector<char> buf(text_size);
+//         vector<line_ref> lines;
+//         lines.reserve(max_lines);
+//         size_t carry=0;
+//         for(;;){
+//                 size_t n=fread(buf.data()+carry, 1, buf.size()-carry, fp.get());
+//                 size_t len=carry+n;
+//                 if(len==0){
+//                         break;
+//                 }
+//                 if(n==0 && buf[len-1]!='\n'){
+//                         if(len==buf.size()){
+//                                 buf.resize(len+1);
+//                         }
+//                         buf[len++]='\n'; // 最後の行に改行が無い
+//                 }
+//
+//                 lines.clear();
+//                 size_t begin=0;
+//                 for(char const* p=buf.data(); lines.size()<max_lines; ){
+//                         auto nl=static_cast<char const*>(memchr(p+begin, '\n', len-begin));
+//                         if(!nl){
+//                                 break;
+//                         }
+//                         lines.push_back({uint32_t(begin), uint32_t(nl-(p+begin))});
+//                         begin=nl-p+1;
+//                 }
+//                 if(lines.empty()){
+//                         if(len>numeric_limits<uint32_t>::max()/2){
+//                                 return false; // line_refで表せない長さの行
+//                         }
+//                         buf.resize(len*2); // 1行がテキストの領域より長い
+//                         carry=len;
+//                         continue;
+//                 }
+//
+//                 // threads個の区間を並列にソートし，隣り合う区間を並列にマージしていく
+//                 char const* text=buf.data();
+//                 auto less=[text](line_ref a, line_ref b){
+//                         return string_view(text+a.begin, a.size)<string_view(text+b.begin, b.size);
+//                 };
+//                 vector<size_t> bounds;
+//                 for(unsigned t=0; t<=threads; ++t){
+//                         bounds.push_back(lines.size()*t/threads);
+//                 }
+//                 auto slice=[&](size_t t){ return lines.begin()+bounds[min<size_t>(t, threads)]; };
+//                 for(size_t width=1; ; width*=2){
+//                         vector<thread> ts;
+//                         for(size_t t=0; t<threads; t+=2*width){
+//                                 ts.emplace_back([=]{
+//                                         trace::scope s("sort run");
+//                                         if(width==1){
+//                                                 sort(slice(t), slice(t+1), less);
+//                                                 sort(slice(t+1), slice(t+2), less);
+//                                         }
+//                                         inplace_merge(slice(t), slice(t+width), slice(t+2*width), less);
+//                                 });
+//                         }
+//                         for(auto& t: ts){
+//                                 t.join();
+//                         }
+//                         if(2*width>=threads){
+//                                 break;
+//                         }
+//                 }
+//
+//                 trace::scope s("write run");
+//                 runs.push_back(string(out)+".run"+to_string(runs.size()));
+//                 unique_ptr<FILE, int (*)(FILE*)> run(fopen(runs.back().c_str(), "wb"), &fclose);
+//                 if(!run){
+//                         return false;
+//                 }
+//                 for(auto const& l: lines){
+//                         fwrite(text+l.begin, 1, l.size, run.get());
+//                         fputc('\n', run.get());
+//                 }
+//                 if(ferror(run.get()) || fclose(run.release())!=0){
+//                         return false;
+//                 }
+//
+//                 carry=len-begin;
+//                 memmove(buf.data(), buf.data()+begin, carry);
+//                 if(buf.size()>text_size && carry<=text_size){
+//                         vector<char> small(text_size); // 長い行のために広げた分を返す
+//                         memcpy(small.data(), buf.data(), carry);
+//                         buf.swap(small);
+//                 }
+//                 if(n==0 && carry==0){
+//                         break;
+//                 }
+//         }
+//         return !ferror(fp.get());
+// }
+//
+// // 2. pathsをk-wayマージしてoutに書き出す，読み込みバッファは先読み分と書き込み分も含めてbudget内に収める
+// bool merge_runs(vector<string> const& paths, char const* out, size_t budget)
+// {
+//         trace::scope s("merge runs");
+//         size_t buffer_size=max<size_t>(budget/(2*paths.size()+2), 1);
+//         prefetcher pf; // readersより先に作り，後で壊す
+//         vector<unique_ptr<run_reader>> runs;
+//         for(auto const& p: paths){
+//                 runs.push_back(make_unique<run_reader>(p.c_str(), buffer_size, pf));
+//                 if(runs.back()->error()){
+//                         return false;
+//                 }
+//         }
+//
+//         unique_ptr<FILE, int (*)(FILE*)> ofp(fopen(out, "wb"), &fclose);
+//         if(!ofp){
+//                 return false;
+//         }
+//         vector<char> obuf(2*buffer_size);
+//         setvbuf(ofp.get(), obuf.data(), _IOFBF, obuf.size());
+//         for(loser_tree tree(runs); run_reader* r=tree.top(); tree.pop()){
+//                 fwrite(r->line().data(), 1, r->line().size(), ofp.get());
+//                 fputc('\n', ofp.get());
+//         }
+//         bool ok=!ferror(ofp.get()) && fclose(ofp.release())==0;
+//         for(auto const& r: runs){
+//                 ok=ok && !r->error();
+//         }
+//         return ok;
+// }
+//
+// // 1つのランの読み込みバッファは最低でもmin_buffer，同時にマージするランの数はそれで決まる
+// // 入力や一時ファイルを開けない，読み書きに失敗した場合はfalseを返す
+// bool external_sort(char const* in, char const* out, size_t budget, unsigned threads=thread::hardware_concurrency())
+// {
+//         constexpr size_t min_buffer=64*1024;
+//         size_t const fan_in=max<size_t>(budget/(2*min_buffer), 3)-1;
+//
+//         vector<string> paths;
+//         bool ok=make_runs(in, out, budget, max(threads, 1u), paths);
+//         vector<string> temps=paths; // 最後に消す
+//         size_t serial=paths.size();
+//         while(ok && paths.size()>fan_in){
+//                 vector<string> next;
+//                 for(size_t i=0; ok && i<paths.size(); i+=fan_in){
+//                         vector<string> group(paths.begin()+i, paths.begin()+min(i+fan_in, paths.size()));
+//                         if(group.size()==1){
+//                                 next.push_back(group[0]);
+//                                 continue;
+//                         }
+//                         next.push_back(string(out)+".run"+to_string(serial++));
+//                         temps.push_back(next.back());
+//                         ok=merge_runs(group, next.back().c_str(), budget);
+//                         for(auto const& p: group){
+//                                 remove(p.c_str()); // 次の段では使わないので早めに消す
+//                         }
+//                 }
+//                 paths.swap(next);
+//         }
+//         ok=ok && merge_runs(paths, out, budget);
+//
+//         for(auto const& p: temps){
+//                 remove(p.c_str());
+//         }
+//         return ok;
+// }
+//
+// // メモリ予算の1倍，10倍，100倍のファイルでスループットを測る
+// void bench_external_sort(size_t budget)
+// {
+//         mt19937 gen(1987);
+//         char const* words[]={"hoge", "fuga", "foo", "bar", "aaaaaaaaaaaaaa"};
+//         for(size_t times: {1, 10, 100}){
+//                 {
+//                         ofstream ofs("abc.txt");
+//                         for(size_t size=0; size<budget*times; ){
+//                                 string line=string(words[gen()%5])+' '+to_string(gen());
+//                                 ofs << line << '\n';
+//                                 size+=line.size()+1;
+//                         }
+//                 }
+//
+//                 auto start=chrono::steady_clock::now();
+//                 if(!external_sort("abc.txt", "def.txt", budget)){
+//                         cout << "external_sort failed" << endl;
+//                         return;
+//                 }
+//                 chrono::duration<double> d=chrono::steady_clock::now()-start;
+//
+//                 ifstream ifs("def.txt");
+//                 string prev, str;
+//                 bool sorted=true;
+//                 while(getline(ifs, str)){
+//                         sorted&=prev<=str;
+//                         prev.swap(str);
+//                 }
+//                 cout << times << "x budget: " << budget*times/d.count()/(1<<20) << " MB/s"
+//                      << (sorted ? "" : " (not sorted)") << endl;
+//         }
+// }
+
+
+/**
+ * 行単位の処理(filter，transform，count，unique，sort)を並列に行いたい
+ * [algorithms.parallel],[execpol]
+ */
+// // 上の例のようにファイルを1行ずつ処理すると1コアしか使わない
+// // テキストを改行の位置で塊(chunk)に分け，塊ごとの処理をスレッドプールで並列に実行する
+// // 結果は塊の順に連結するので，出力の順序は逐次処理と同じになる
+// // std::execution::parは，libstdc++ではTBBが無いと逐次実行になり，TBBのヘッダだけあって-ltbbでリンクしないとリンクエラーになる
+// // (__cpp_lib_executionはTBBの有無に関わらず定義されるので，これでは判定できない)
+// // またスレッド数を指定できないので，どの環境でも同じように動き，スレッド数を変えて測れるように，
+// // 簡単なワークスティーリングのスレッドプールを用意しておく
+// // ・スレッド毎にタスクのキューを持ち，自分のキューは後ろから，他のスレッドのキューは前から取る(steal)
+// // ・呼び出したスレッドも，全てのタスクが終わるまでタスクを実行する
+// class steal_pool{
+//         struct queue{
+//                 mutex mtx;
+//                 deque<function<void()>> tasks;
+//         };
+//
+//         vector<unique_ptr<queue>> m_queues; // 最後のキューは呼び出し側のスレッド用
+//         vector<thread> m_threads;
+//         atomic<size_t> m_queued{0};
+//         mutex m_mtx;
+//         condition_variable m_cv;
+//         bool m_stop=false;
+//
+//         bool try_run(size_t self)
+//         {
+//                 function<void()> task;
+//                 for(size_t i=0; i<m_queues.size() && !task; ++i){
+//                         queue& q=*m_queues[(self+i)%m_queues.size()];
+//                         lock_guard<mutex> lock(q.mtx);
+//                         if(q.tasks.empty()){
+//                                 continue;
+//                         }
+//                         if(i==0){
+//                                 task=move(q.tasks.back());
+//                                 q.tasks.pop_back();
+//                         }else{
+//                                 task=move(q.tasks.front());
+//                                 q.tasks.pop_front();
+//                         }
+//                 }
+//                 if(!task){
+//                         return false;
+//                 }
+//                 --m_queued;
+//                 task();
+//                 return true;
+//         }
+//
+//         void work(size_t self)
+//         {
+//                 for(;;){
+//                         if(try_run(self)){
+//                                 continue;
+//                         }
+//                         unique_lock<mutex> lock(m_mtx);
+//                         m_cv.wait(lock, [this]{ return m_stop || m_queued>0; });
+//                         if(m_stop){
+//                                 return;
+//                         }
+//                 }
+//         }
+// public:
+//         explicit steal_pool(unsigned threads=thread::hardware_concurrency())
+//         {
+//                 threads=max(threads, 1u);
+//                 for(unsigned i=0; i<threads; ++i){
+//                         m_queues.push_back(make_unique<queue>());
+//                 }
+//                 for(unsigned i=0; i+1<threads; ++i){
+//                         m_threads.emplace_back([this, i]{ work(i); });
+//                 }
+//         }
+//
+//         ~steal_pool()
+//         {
+//                 {
+//                         lock_guard<mutex> lock(m_mtx);
+//                         m_stop=true;
+//                 }
+//                 m_cv.notify_all();
+//                 for(auto& t: m_threads){
+//                         t.join();
+//                 }
+//         }
+//
+//         size_t size() const
+//         {
+//                 return m_queues.size();
+//         }
+//
+//         // f(0)〜f(n-1)を並列に実行し，全て終わるまで待つ
+//         template<typename F>
+//         void parallel_for(size_t n, F const& f)
+//         {
+//                 atomic<size_t> left{n};
+//                 {
+//                         lock_guard<mutex> lock(m_mtx);
+//                         m_queued+=n;
+//                 }
+//                 for(size_t i=0; i<n; ++i){
+//                         queue& q=*m_queues[i%m_queues.size()];
+//                         lock_guard<mutex> lock(q.mtx);
+//                         q.tasks.emplace_back([&f, &left, i]{
+//                                 {
+//                                         trace::scope s("parallel_for task");
+//                                         f(i);
+//                                 }
+//                                 --left;
+//                         });
+//                 }
+//                 m_cv.notify_all();
+//                 while(left>0){
+//                         if(!try_run(m_queues.size()-1)){
+//                                 this_thread::yield();
+//                         }
+//                 }
+//         }
+// };
+//
+// // 改行の直後で区切って，およそchunk_sizeバイトずつに分ける
+// vector<string_view> split_chunks(string_view text, size_t chunk_size=1<<20)
+// {
+//         vector<string_view> chunks;
+//         while(!text.empty()){
+//                 size_t end=text.find('\n', min(chunk_size, text.size()-1));
+//                 end=end==string_view::npos ? text.size() : end+1;
+//                 chunks.push_back(text.substr(0, end));
+//                 text.remove_prefix(end);
+//         }
+//         return chunks;
+// }
+//
+// template<typename F>
+// void for_each_line(string_view chunk, F f)
+// {
+//         while(!chunk.empty()){
+//                 size_t nl=chunk.find('\n');
+//                 f(chunk.substr(0, nl));
+//                 chunk.remove_prefix(nl==string_view::npos ? chunk.size() : nl+1);
+//         }
+// }
+//
+// // 塊ごとの結果を塊の順に並べて返す
+// template<typename R, typename F>
+// vector<R> map_chunks(steal_pool& pool, vector<string_view> const& chunks, F f)
+// {
+//         vector<R> results(chunks.size());
+//         pool.parallel_for(chunks.size(), [&](size_t i){ results[i]=f(chunks[i]); });
+//         return results;
+// }
+//
+// template<typename T>
+// vector<T> concat(vector<vector<T>>&& parts)
+// {
+//         size_t n=0;
+//         for(auto const& p: parts){
+//                 n+=p.size();
+//         }
+//         vector<T> out;
+//         out.reserve(n);
+//         for(auto& p: parts){
+//                 move(p.begin(), p.end(), back_inserter(out));
+//         }
+//         return out;
+// }
+//
+// template<typename Pred>
+// vector<string_view> par_filter(steal_pool& pool, vector<string_view> const& chunks, Pred pred)
+// {
+//         trace::scope s("par_filter");
+//         return concat(map_chunks<vector<string_view>>(pool, chunks, [&](string_view c){
+//                 vector<string_view> kept;
+//                 for_each_line(c, [&](string_view line){
+//                         if(pred(line)){
+//                                 kept.push_back(line);
+//                         }
+//                 });
+//                 return kept;
+//         }));
+// }
+//
+// template<typename F>
+// vector<string> par_transform(steal_pool& pool, vector<string_view> const& chunks, F f)
+// {
+//         trace::scope s("par_transform");
+//         return concat(map_chunks<vector<string>>(pool, chunks, [&](string_view c){
+//                 vector<string> out;
+//                 for_each_line(c, [&](string_view line){ out.push_back(f(line)); });
+//                 return out;
+//         }));
+// }
+//
+// template<typename Pred>
+// size_t par_count(steal_pool& pool, vector<string_view> const& chunks, Pred pred)
+// {
+//         trace::scope s("par_count");
+//         auto counts=map_chunks<size_t>(pool, chunks, [&](string_view c){
+//                 size_t n=0;
+//                 for_each_line(c, [&](string_view line){ n+=pred(line); });
+//                 return n;
+//         });
+//         return accumulate(counts.begin(), counts.end(), size_t{0});
+// }
+//
+// // 隣り合う同じ行を1つにする(std::uniqueと同じ)
+// // 塊の境界を跨ぐ重複は，連結する時に前の塊の最後の行と比べて取り除く
+// vector<string_view> par_unique(steal_pool& pool, vector<string_view> const& lines)
+// {
+//         trace::scope s("par_unique");
+//         size_t const n=lines.size(), parts=pool.size()*4;
+//         vector<vector<string_view>> kept(parts);
+//         pool.parallel_for(parts, [&](size_t p){
+//                 auto first=lines.begin()+n*p/parts, last=lines.begin()+n*(p+1)/parts;
+//                 unique_copy(first, last, back_inserter(kept[p]));
+//         });
+//
+//         vector<string_view> out;
+//         for(auto& k: kept){
+//                 auto it=k.begin();
+//                 if(it!=k.end() && !out.empty() && out.back()==*it){
+//                         ++it;
+//                 }
+//                 out.insert(out.end(), it, k.end());
+//         }
+//         return out;
+// }
+//
+// // 塊ごとにソートしてから，2つずつ並列にマージしていく
+// vector<string_view> par_sort(steal_pool& pool, vector<string_view> const& chunks)
+// {
+//         trace::scope s("par_sort");
+//         auto runs=map_chunks<vector<string_view>>(pool, chunks, [](string_view c){
+//                 vector<string_view> lines;
+//                 for_each_line(c, [&](string_view line){ lines.push_back(line); });
+//                 sort(lines.begin(), lines.end());
+//                 return lines;
+//         });
+//         while(runs.size()>1){
+//                 vector<vector<string_view>> merged((runs.size()+1)/2);
+//                 pool.parallel_for(merged.size(), [&](size_t i){
+//                         if(2*i+1==runs.size()){
+//                                 merged[i]=move(runs[2*i]);
+//                                 return;
+//                         }
+//                         auto& a=runs[2*i];
+//                         auto& b=runs[2*i+1];
+//                         merged[i].resize(a.size()+b.size());
+//                         merge(a.begin(), a.end(), b.begin(), b.end(), merged[i].begin());
+//                 });
+//                 runs=move(merged);
+//         }
+//         return runs.empty() ? vector<string_view>{} : move(runs[0]);
+// }
+//
+// // sample.txtを指定の大きさまで増やし，1〜Nスレッドでの時間と並列化効率(T1/(p*Tp))を測る
+// void bench_line_ops(size_t mega_bytes)
+// {
+//         ifstream ifs("sample.txt");
+//         string sample((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+//         string text;
+//         for(size_t i=0; text.size()<mega_bytes<<20; ++i){
+//                 text+=sample;
+//                 text+=to_string(i*2654435761u%1'000'000);
+//                 text+='\n';
+//         }
+//         auto chunks=split_chunks(text);
+//
+//         double t1=0;
+//         for(unsigned threads=1; threads<=max(thread::hardware_concurrency(), 1u); threads*=2){
+//                 steal_pool pool(threads);
+//                 auto start=chrono::steady_clock::now();
+//
+//                 auto filtered=par_filter(pool, chunks, [](string_view s){ return s.find('a')!=string_view::npos; });
+//                 auto upper=par_transform(pool, chunks, [](string_view s){
+//                         string u(s);
+//                         for(auto& c: u){
+//                                 c=static_cast<char>(toupper(static_cast<unsigned char>(c)));
+//                         }
+//                         return u;
+//                 });
+//                 size_t fs=par_count(pool, chunks, [](string_view s){ return !s.empty() && s[0]=='f'; });
+//                 auto sorted=par_sort(pool, chunks);
+//                 auto uniq=par_unique(pool, sorted);
+//
+//                 chrono::duration<double> d=chrono::steady_clock::now()-start;
+//                 if(threads==1){
+//                         t1=d.count();
+//                 }
+//                 cout << threads << " threads: " << d.count() << " s, efficiency " << t1/(threads*d.count())
+//                      << " (" << filtered.size() << ", " << upper.size() << ", " << fs << ", " << uniq.size() << ")" << endl;
+//         }
+// }
+
+
+/**
+ * ワークスティーリングのタスクスケジューラを作りたい
+ * [intro.multithread],[atomics.fences]
+ */
+// // 上のsteal_poolはキューをmutexで保護しているので，タスクが細かくなるとロックの取り合いが増える
+// // fib，nqueensのような再帰的な分割統治(fork-join)では，タスクは1回あたり数十ns程度になる
+// // ・ワーカー毎にChase-Lev両端キューを持つ
+// //   持ち主はbottom側でロック無しにpush/popし，他のワーカーはtop側からCASで盗む
+// //   持ち主と盗む側が競合するのは，残り1個を取り合う場合だけになる
+// // ・仕事が無いワーカーは，何度か盗みに失敗したらfutexで眠る(parking)
+// //   pushした側は眠っているワーカーがいる時だけfutexで起こすので，忙しい時はシステムコールを呼ばない
+// // ・spawnで子タスクを作り，syncで子が全て終わるまで待つ
+// //   待っている間も自分のキューのタスクを実行したり，他のキューから盗んだりする
+// // ・continue_withで継続タスクを作ると，現在のタスクは子を待たずに終わり，
+// //   最後の子が終わった時に継続タスクがキューに入る(スタックを消費しない継続渡し)
+// // ・ワーカー以外のスレッドからのspawnは，持ち主しか触れないChase-Levキューではなく，mutexで保護した投入用のキューに入れる
+// //   どのワーカーかはスレッドごとに持つが，複数のスケジューラがあっても混ざらないようにどのスケジューラのワーカーかも持つ
+// struct join_point{
+//         atomic<int> pending{0};
+//         struct task* cont=nullptr; // 0になった時に実行する継続タスク
+// };
+//
+// struct task{
+//         join_point* m_join=nullptr; // 終わった時に通知する先
+//         join_point m_children; // 継続タスクとして子を待つ場合に使う
+//         task* m_next=nullptr; // このタスクが作った継続タスク
+//
+//         virtual ~task()=default;
+//         virtual void run()=0;
+// };
+//
+// template<typename F>
+// struct fn_task: task{
+//         F f;
+//         explicit fn_task(F&& f):f{move(f)}{}
+//         void run() override { f(); }
+// };
+//
+// void futex_wait(atomic<uint32_t>* addr, uint32_t expected)
+// {
+// #ifdef __linux__
+//         syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+// #else
+//         if(addr->load()==expected){
+//                 this_thread::yield();
+//         }
+// #endif
+// }
+//
+// void futex_wake(atomic<uint32_t>* addr, int n)
+// {
+// #ifdef __linux__
+//         syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, n, nullptr, nullptr, 0);
+// #endif
+// }
+//
+// // Lê, Pop, Cohen, Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models" (2013) のC11版
+// class chase_lev{
+//         struct ring{
+//                 int64_t mask;
+//                 unique_ptr<atomic<task*>[]> buf;
+//
+//                 explicit ring(int64_t cap):mask{cap-1}, buf{new atomic<task*>[cap]}{}
+//                 task* get(int64_t i) const { return buf[i&mask].load(memory_order_relaxed); }
+//                 void put(int64_t i, task* t){ buf[i&mask].store(t, memory_order_relaxed); }
+//         };
+//
+//         alignas(64) atomic<int64_t> m_top{0};
+//         alignas(64) atomic<int64_t> m_bottom{0};
+//         atomic<ring*> m_ring;
+//         vector<unique_ptr<ring>> m_rings; // 盗む側がまだ読んでいるかもしれないので，古い配列も破棄時まで残す
+//
+//         ring* grow(ring* r, int64_t top, int64_t bottom)
+//         {
+//                 auto bigger=make_unique<ring>(2*(r->mask+1));
+//                 for(int64_t i=top; i<bottom; ++i){
+//                         bigger->put(i, r->get(i));
+//                 }
+//                 r=bigger.get();
+//                 m_rings.push_back(move(bigger));
+//                 m_ring.store(r, memory_order_release);
+//                 return r;
+//         }
+// public:
+//         explicit chase_lev(int64_t capacity=256)
+//         {
+//                 m_rings.push_back(make_unique<ring>(capacity));
+//                 m_ring.store(m_rings.back().get(), memory_order_relaxed);
+//         }
+//
+//         // 持ち主だけが呼ぶ
+//         void push(task* t)
+//         {
+//                 int64_t b=m_bottom.load(memory_order_relaxed);
+//                 int64_t top=m_top.load(memory_order_acquire);
+//                 ring* r=m_ring.load(memory_order_relaxed);
+//                 if(b-top>r->mask){
+//                         r=grow(r, top, b);
+//                 }
+//                 r->put(b, t);
+//                 atomic_thread_fence(memory_order_release);
+//                 m_bottom.store(b+1, memory_order_relaxed);
+//         }
+//
+//         // 持ち主だけが呼ぶ，最後に入れたものを取り出す(LIFO)
+//         task* pop()
+//         {
+//                 int64_t b=m_bottom.load(memory_order_relaxed)-1;
+//                 ring* r=m_ring.load(memory_order_relaxed);
+//                 m_bottom.store(b, memory_order_relaxed);
+//                 atomic_thread_fence(memory_order_seq_cst);
+//                 int64_t top=m_top.load(memory_order_relaxed);
+//                 if(top>b){
+//                         m_bottom.store(b+1, memory_order_relaxed); // 空だった
+//                         return nullptr;
+//                 }
+//                 task* t=r->get(b);
+//                 if(top==b){ // 最後の1個は盗む側と取り合う
+//                         if(!m_top.compare_exchange_strong(top, top+1, memory_order_seq_cst, memory_order_relaxed)){
+//                                 t=nullptr;
+//                         }
+//                         m_bottom.store(b+1, memory_order_relaxed);
+//                 }
+//                 return t;
+//         }
+//
+//         // 他のスレッドが呼ぶ，最初に入れたものを取り出す(FIFO)
+//         // 先に入れたタスクほど大きな部分問題なので，1回盗めば当分は自分のキューで足りる
+//         task* steal()
+//         {
+//                 int64_t top=m_top.load(memory_order_acquire);
+//                 atomic_thread_fence(memory_order_seq_cst);
+//                 int64_t b=m_bottom.load(memory_order_acquire);
+//                 if(top>=b){
+//                         return nullptr;
+//                 }
+//                 task* t=m_ring.load(memory_order_acquire)->get(top);
+//                 if(!m_top.compare_exchange_strong(top, top+1, memory_order_seq_cst, memory_order_relaxed)){
+//                         return nullptr; // 他の盗む側か持ち主に負けた
+//                 }
+//                 return t;
+//         }
+// };
+//
+// class ws_scheduler{
+//         struct alignas(64) worker{
+//                 chase_lev deque;
+//                 uint64_t rng;
+//         };
+//
+//         unique_ptr<worker[]> m_workers; // 0番はrunを呼んだスレッド用
+//         size_t m_size;
+//         vector<thread> m_threads;
+//         alignas(64) atomic<uint32_t> m_epoch{0}; // futexで待つ値，起こす度に進める
+//         atomic<int> m_sleepers{0};
+//         atomic<bool> m_stop{false};
+//
+//         mutex m_inject_mtx;
+//         deque<task*> m_injected; // ワーカー以外のスレッドがspawnしたタスク
+//         atomic<size_t> m_injected_count{0};
+//
+//         static inline thread_local ws_scheduler* t_owner=nullptr; // このスレッドがワーカーとして属するスケジューラ
+//         static inline thread_local size_t t_index=0;
+//         static inline thread_local task* t_current=nullptr;
+//
+//         // このスケジューラのワーカーのスレッドなら自分のworker，それ以外はnullptr
+//         worker* self()
+//         {
+//                 return t_owner==this ? &m_workers[t_index] : nullptr;
+//         }
+//
+//         void push(task* t)
+//         {
+//                 if(worker* w=self()){
+//                         w->deque.push(t);
+//                 }else{
+//                         lock_guard<mutex> lock(m_inject_mtx);
+//                         m_injected.push_back(t);
+//                         m_injected_count.fetch_add(1, memory_order_relaxed);
+//                 }
+//                 // 眠ろうとしている側のm_sleepersの増加とpushのどちらかが，もう一方から必ず見える
+//                 atomic_thread_fence(memory_order_seq_cst);
+//                 if(m_sleepers.load(memory_order_relaxed)>0){
+//                         m_epoch.fetch_add(1, memory_order_release);
+//                         futex_wake(&m_epoch, 1);
+//                 }
+//         }
+//
+//         task* take_injected()
+//         {
+//                 if(m_injected_count.load(memory_order_seq_cst)==0){ // pushのフェンスと対になる
+//                         return nullptr;
+//                 }
+//                 lock_guard<mutex> lock(m_inject_mtx);
+//                 if(m_injected.empty()){
+//                         return nullptr;
+//                 }
+//                 task* t=m_injected.front();
+//                 m_injected.pop_front();
+//                 m_injected_count.fetch_sub(1, memory_order_relaxed);
+//                 return t;
+//         }
+//
+//         // ワーカー以外のスレッドがsyncで待つ間は，投入用のキューと盗みだけで手伝う
+//         task* find_task()
+//         {
+//                 worker* w=self();
+//                 if(w){
+//                         if(task* t=w->deque.pop()){
+//                                 return t;
+//                         }
+//                 }
+//                 if(task* t=take_injected()){
+//                         return t;
+//                 }
+//                 if(w && m_size==1){
+//                         return nullptr;
+//                 }
+//                 // 盗む相手は乱数で選ぶ(xorshift)，ワーカー以外のスレッドは順に見る
+//                 for(size_t attempt=0; attempt<2*m_size; ++attempt){
+//                         size_t victim=attempt%m_size;
+//                         if(w){
+//                                 w->rng^=w->rng<<13;
+//                                 w->rng^=w->rng>>7;
+//                                 w->rng^=w->rng<<17;
+//                                 victim=w->rng%m_size;
+//                                 if(victim==t_index){
+//                                         continue;
+//                                 }
+//                         }
+//                         if(task* t=m_workers[victim].deque.steal()){
+//                                 return t;
+//                         }
+//                 }
+//                 return nullptr;
+//         }
+//
+//         void finish(join_point* j)
+//         {
+//                 task* cont=j->cont; // 0になった後はjが破棄されているかもしれない
+//                 if(j->pending.fetch_sub(1, memory_order_acq_rel)==1 && cont){
+//                         push(cont);
+//                 }
+//         }
+//
+//         void execute(task* t)
+//         {
+//                 task* parent=exchange(t_current, t);
+//                 {
+//                         trace::scope s("ws task");
+//                         t->run();
+//                 }
+//                 t_current=parent;
+//
+//                 join_point* j=t->m_join;
+//                 task* next=t->m_next;
+//                 delete t;
+//                 if(next){
+//                         finish(&next->m_children); // 子をspawnし終えたので，continue_withで足した1を引く
+//                 }else if(j){
+//                         finish(j);
+//                 }
+//         }
+//
+//         void work(size_t index)
+//         {
+//                 t_owner=this;
+//                 t_index=index;
+//                 while(!m_stop.load(memory_order_relaxed)){
+//                         task* t=nullptr;
+//                         for(int spin=0; spin<64 && !t; ++spin){
+//                                 t=find_task();
+//                         }
+//                         if(t){
+//                                 execute(t);
+//                                 continue;
+//                         }
+//
+//                         uint32_t epoch=m_epoch.load(memory_order_acquire);
+//                         m_sleepers.fetch_add(1, memory_order_seq_cst);
+//                         t=find_task(); // 眠る前にもう一度確認する
+//                         if(!t && !m_stop.load()){
+//                                 futex_wait(&m_epoch, epoch);
+//                         }
+//                         m_sleepers.fetch_sub(1, memory_order_relaxed);
+//                         if(t){
+//                                 execute(t);
+//                         }
+//                 }
+//         }
+// public:
+//         explicit ws_scheduler(unsigned threads=thread::hardware_concurrency()):m_size{max(threads, 1u)}
+//         {
+//                 m_workers.reset(new worker[m_size]);
+//                 for(size_t i=0; i<m_size; ++i){
+//                         m_workers[i].rng=0x9e3779b97f4a7c15*(i+1);
+//                 }
+//                 for(size_t i=1; i<m_size; ++i){
+//                         m_threads.emplace_back([this, i]{ work(i); });
+//                 }
+//         }
+//
+//         ~ws_scheduler()
+//         {
+//                 m_stop=true;
+//                 m_epoch.fetch_add(1);
+//                 futex_wake(&m_epoch, INT_MAX);
+//                 for(auto& t: m_threads){
+//                         t.join();
+//                 }
+//         }
+//
+//         ws_scheduler(ws_scheduler const&)=delete;
+//         ws_scheduler& operator=(ws_scheduler const&)=delete;
+//
+//         template<typename F>
+//         void spawn(join_point& j, F f)
+//         {
+//                 task* t=new fn_task<F>(move(f));
+//                 t->m_join=&j;
+//                 j.pending.fetch_add(1, memory_order_relaxed);
+//                 push(t);
+//         }
+//
+//         // jの子が全て終わるまで，他のタスクを実行しながら待つ
+//         void sync(join_point& j)
+//         {
+//                 while(j.pending.load(memory_order_acquire)>0){
+//                         if(task* t=find_task()){
+//                                 execute(t);
+//                         }else{
+//                                 this_thread::yield();
+//                         }
+//                 }
+//         }
+//
+//         // 現在のタスクの継続を作る，返したjoin_pointにspawnした子が全て終わるとfが実行される
+//         // 現在のタスクの完了の通知は継続タスクに引き継がれる
+//         // このスケジューラのタスクの中から，1つのタスクにつき1回だけ呼べる(継続タスクの中でさらに継続を作るのはよい)
+//         template<typename F>
+//         join_point& continue_with(F f)
+//         {
+//                 if(!t_current || t_owner!=this){
+//                         throw logic_error("continue_with outside a task of this scheduler");
+//                 }
+//                 if(t_current->m_next){
+//                         throw logic_error("continue_with called twice in the same task");
+//                 }
+//                 task* c=new fn_task<F>(move(f));
+//                 c->m_join=exchange(t_current->m_join, nullptr);
+//                 c->m_children.pending=1; // 現在のタスクが終わるまでは実行しない
+//                 c->m_children.cont=c;
+//                 t_current->m_next=c;
+//                 return c->m_children;
+//         }
+//
+//         // 外のスレッドから呼ぶ，そのスレッドは0番のワーカーとしてfが終わるまで手伝う
+//         // 同時にrunを呼べるのは1つのスレッドだけ
+//         template<typename F>
+//         void run(F f)
+//         {
+//                 auto owner=exchange(t_owner, this);
+//                 auto index=exchange(t_index, 0);
+//                 join_point root;
+//                 spawn(root, move(f));
+//                 sync(root);
+//                 t_owner=owner;
+//                 t_index=index;
+//         }
+// };
+//
+// // 比較用の，1つのmutexで保護したキューを全スレッドで共有するプール
+// class global_pool{
+//         mutex m_mtx;
+//         condition_variable m_cv;
+//         deque<pair<function<void()>, join_point*>> m_tasks;
+//         vector<thread> m_threads;
+//         bool m_stop=false;
+//
+//         bool try_run()
+//         {
+//                 unique_lock<mutex> lock(m_mtx);
+//                 if(m_tasks.empty()){
+//                         return false;
+//                 }
+//                 // 古いタスクから取ると，syncの中で大きな部分問題を次々に始めてスタックが溢れるので，新しいものから取る
+//                 auto [f, j]=move(m_tasks.back());
+//                 m_tasks.pop_back();
+//                 lock.unlock();
+//                 f();
+//                 j->pending.fetch_sub(1, memory_order_release);
+//                 return true;
+//         }
+// public:
+//         explicit global_pool(unsigned threads=thread::hardware_concurrency())
+//         {
+//                 for(unsigned i=1; i<max(threads, 1u); ++i){
+//                         m_threads.emplace_back([this]{
+//                                 for(;;){
+//                                         if(try_run()){
+//                                                 continue;
+//                                         }
+//                                         unique_lock<mutex> lock(m_mtx);
+//                                         m_cv.wait(lock, [this]{ return m_stop || !m_tasks.empty(); });
+//                                         if(m_stop){
+//                                                 return;
+//                                         }
+//                                 }
+//                         });
+//                 }
+//         }
+//
+//         ~global_pool()
+//         {
+//                 {
+//                         lock_guard<mutex> lock(m_mtx);
+//                         m_stop=true;
+//                 }
+//                 m_cv.notify_all();
+//                 for(auto& t: m_threads){
+//                         t.join();
+//                 }
+//         }
+//
+//         template<typename F>
+//         void spawn(join_point& j, F f)
+//         {
+//                 j.pending.fetch_add(1, memory_order_relaxed);
+//                 {
+//                         lock_guard<mutex> lock(m_mtx);
+//                         m_tasks.emplace_back(move(f), &j);
+//                 }
+//                 m_cv.notify_one();
+//         }
+//
+//         void sync(join_point& j)
+//         {
+//                 while(j.pending.load(memory_order_acquire)>0){
+//                         if(!try_run()){
+//                                 this_thread::yield();
+//                         }
+//                 }
+//         }
+//
+//         template<typename F>
+//         void run(F f)
+//         {
+//                 f();
+//         }
+// };
+//
+// int const fib_cutoff=12;
+//
+// long fib_seq(int n)
+// {
+//         return n<2 ? n : fib_seq(n-1)+fib_seq(n-2);
+// }
+//
+// template<typename Pool>
+// long fib(Pool& pool, int n)
+// {
+//         if(n<fib_cutoff){
+//                 return fib_seq(n);
+//         }
+//         long a, b;
+//         join_point j;
+//         pool.spawn(j, [&]{ a=fib(pool, n-1); });
+//         b=fib(pool, n-2);
+//         pool.sync(j);
+//         return a+b;
+// }
+//
+// // 継続渡しのfib，子の結果は継続タスクが持つ領域に書き込む
+// void fib_cont(ws_scheduler& s, int n, long* out)
+// {
+//         if(n<fib_cutoff){
+//                 *out=fib_seq(n);
+//                 return;
+//         }
+//         auto r=new long[2];
+//         join_point& j=s.continue_with([out, r]{
+//                 *out=r[0]+r[1];
+//                 delete[] r;
+//         });
+//         s.spawn(j, [&s, n, r]{ fib_cont(s, n-1, r); });
+//         s.spawn(j, [&s, n, r]{ fib_cont(s, n-2, r+1); });
+// }
+//
+// // 行，左斜め，右斜めの使用中の列をビットで持つ
+// long nqueens_seq(uint32_t all, uint32_t cols, uint32_t d1, uint32_t d2)
+// {
+//         if(cols==all){
+//                 return 1;
+//         }
+//         long n=0;
+//         for(uint32_t avail=all&~(cols|d1|d2); avail; avail&=avail-1){
+//                 uint32_t bit=avail&-avail;
+//                 n+=nqueens_seq(all, cols|bit, (d1|bit)<<1, (d2|bit)>>1);
+//         }
+//         return n;
+// }
+//
+// template<typename Pool>
+// long nqueens(Pool& pool, int n, int row=0, uint32_t cols=0, uint32_t d1=0, uint32_t d2=0)
+// {
+//         uint32_t all=(1u<<n)-1;
+//         if(n-row<=8){
+//                 return nqueens_seq(all, cols, d1, d2);
+//         }
+//         long counts[32]={};
+//         join_point j;
+//         for(uint32_t avail=all&~(cols|d1|d2); avail; avail&=avail-1){
+//                 uint32_t bit=avail&-avail;
+//                 pool.spawn(j, [&, bit]{
+//                         counts[__builtin_ctz(bit)]=nqueens(pool, n, row+1, cols|bit, (d1|bit)<<1, (d2|bit)>>1);
+//                 });
+//         }
+//         pool.sync(j);
+//         return accumulate(counts, counts+n, 0L);
+// }
+//
+// template<typename Pool>
+// long parallel_sum(Pool& pool, long const* first, long const* last)
+// {
+//         if(last-first<=4096){
+//                 return accumulate(first, last, 0L);
+//         }
+//         long const* mid=first+(last-first)/2;
+//         long a, b;
+//         join_point j;
+//         pool.spawn(j, [&]{ a=parallel_sum(pool, first, mid); });
+//         b=parallel_sum(pool, mid, last);
+//         pool.sync(j);
+//         return a+b;
+// }
+//
+// template<typename Pool>
+// void bench_tasks(char const* name, unsigned threads, vector<long> const& data)
+// {
+//         Pool pool(threads);
+//         auto time=[&](auto f){
+//                 long r=0;
+//                 auto start=chrono::steady_clock::now();
+//                 pool.run([&]{ r=f(); });
+//                 chrono::duration<double, milli> d=chrono::steady_clock::now()-start;
+//                 cout << d.count() << " ms (" << r << ")  ";
+//         };
+//         cout << name << threads << " threads: fib ";
+//         time([&]{ return fib(pool, 32); });
+//         cout << "nqueens ";
+//         time([&]{ return nqueens(pool, 12); });
+//         cout << "sum ";
+//         time([&]{ return parallel_sum(pool, data.data(), data.data()+data.size()); });
+//         if constexpr(is_same_v<Pool, ws_scheduler>){
+//                 cout << "fib(continuation) ";
+//                 time([&]{
+//                         long r=0;
+//                         join_point j;
+//                         pool.spawn(j, [&]{ fib_cont(pool, 32, &r); });
+//                         pool.sync(j);
+//                         return r;
+//                 });
+//         }
+//         cout << endl;
+// }
+//
+// void bench_tasks()
+// {
+//         vector<long> data(1<<25);
+//         iota(data.begin(), data.end(), 0L);
+//         for(unsigned threads=1; threads<=max(thread::hardware_concurrency(), 1u); threads*=2){
+//                 bench_tasks<global_pool>("global queue  ", threads, data);
+//                 bench_tasks<ws_scheduler>("work stealing ", threads, data);
+//         }
+// }
+
+
+/**
+ * 大きなテキストファイルのN行目に直接シークしたい
+ * [fstream],[istream.unformatted]
+ */
+// // 上の例のようにgetlineで読むと，N行目を読むには先頭から全ての行を読み飛ばす必要がある
+// // 1回走査して各行の終わりの位置を索引ファイル(abc.txt.idx)に保存しておけば，何行目でもO(1)で読める
+// // ・改行の検索は16バイト(AVX2なら32バイト)ずつ比較し，movemaskで改行の位置のビットを得る
+// // ・位置はそのままだと1行8バイトになるので，64行ずつのブロックに分け，
+// //   ブロックの先頭の位置(base)からの差を，ブロック内の最大値が収まる1，2，4，8バイトの固定幅で持つ
+// //   ブロックの表も固定長なので，N行目はブロックの表を引いて幅を掛けるだけで求まる
+// // ・索引ファイルはヘッダ，ブロックの表，差の並びをそのまま並べた形式で，mmapしてそのまま使う
+// //   ブロックの表は余裕を持って確保しておき，追記では表と差の並びの末尾だけを書く
+// // ・ヘッダに索引を作った時のファイルの大きさと末尾4KiBのハッシュ値を持ち，
+// //   ファイルが伸びただけ(ログへの追記)なら，増えた部分だけを走査して更新する
+// //   それ以外(切り詰め，書き換え)の場合は作り直す
+// // ・位置はリトルエンディアンのまま保存する
+//
+// // 読み込み専用でmmapしたファイル
+// class mapped_file{
+//         int m_fd=-1;
+//         char const* m_data=nullptr;
+//         size_t m_size=0;
+// public:
+//         mapped_file()=default;
+//
+//         explicit mapped_file(char const* path):m_fd{open(path, O_RDONLY)}
+//         {
+//                 struct stat st;
+//                 if(m_fd<0 || fstat(m_fd, &st)<0 || st.st_size==0){
+//                         return;
+//                 }
+//                 void* p=mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+//                 if(p!=MAP_FAILED){
+//                         m_data=static_cast<char const*>(p);
+//                         m_size=st.st_size;
+//                 }
+//         }
+//
+//         mapped_file(mapped_file&& other) noexcept:m_fd{exchange(other.m_fd, -1)}, m_data{exchange(other.m_data, nullptr)}, m_size{exchange(other.m_size, 0)}{}
+//
+//         mapped_file& operator=(mapped_file&& other) noexcept
+//         {
+//                 mapped_file tmp(move(other));
+//                 swap(m_fd, tmp.m_fd);
+//                 swap(m_data, tmp.m_data);
+//                 swap(m_size, tmp.m_size);
+//                 return *this;
+//         }
+//
+//         ~mapped_file()
+//         {
+//                 if(m_data){
+//                         munmap(const_cast<char*>(m_data), m_size);
+//                 }
+//                 if(m_fd>=0){
+//                         close(m_fd);
+//                 }
+//         }
+//
+//         string_view view() const
+//         {
+//                 return {m_data, m_size};
+//         }
+// };
+//
+// // [p, p+n)の改行の位置(base+i)ごとにfを呼ぶ
+// template<typename F>
+// void for_each_newline(char const* p, size_t n, uint64_t base, F f)
+// {
+//         size_t i=0;
+// #if defined(__AVX2__)
+//         __m256i const nl=_mm256_set1_epi8('\n');
+//         for(; i+32<=n; i+=32){
+//                 auto m=static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(p+i)), nl)));
+//                 for(; m; m&=m-1){
+//                         f(base+i+__builtin_ctz(m));
+//                 }
+//         }
+// #elif defined(__SSE2__)
+//         __m128i const nl=_mm_set1_epi8('\n');
+//         for(; i+16<=n; i+=16){
+//                 auto m=static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(p+i)), nl)));
+//                 for(; m; m&=m-1){
+//                         f(base+i+__builtin_ctz(m));
+//                 }
+//         }
+// #endif
+//         for(; i<n; ++i){
+//                 if(p[i]=='\n'){
+//                         f(base+i);
+//                 }
+//         }
+// }
+//
+// uint64_t fnv1a(char const* p, size_t n)
+// {
+//         uint64_t h=0xcbf29ce484222325;
+//         for(size_t i=0; i<n; ++i){
+//                 h=(h^static_cast<unsigned char>(p[i]))*0x100000001b3;
+//         }
+//         return h;
+// }
+//
+// // 索引を作った時点のファイルの末尾4KiBのハッシュ値
+// uint64_t tail_fingerprint(string_view text, uint64_t size)
+// {
+//         size_t n=min<uint64_t>(size, 4096);
+//         return fnv1a(text.data()+size-n, n);
+// }
+//
+// class line_index{
+// public:
+//         static constexpr size_t per_block=64;
+//         static constexpr uint32_t version=1;
+//
+//         struct header{
+//                 char magic[4];
+//                 uint32_t version;
+//                 uint64_t lines;
+//                 uint64_t indexed_size; // 最後の改行の次の位置，これより後は次の更新で走査する
+//                 uint64_t fingerprint;
+//                 uint64_t capacity; // ブロックの表に確保してある数，差の並びはその後ろから始まる
+//         };
+//
+//         struct block{
+//                 uint64_t base; // ブロックの最初の行の先頭の位置
+//                 uint64_t data; // 差の並びの中での位置
+//                 uint32_t width;
+//                 uint32_t reserved;
+//         };
+//         static_assert(is_trivially_copyable_v<header> && is_trivially_copyable_v<block>);
+// private:
+//         mapped_file m_file;
+//         header const* m_header=nullptr;
+//         block const* m_blocks=nullptr;
+//         uint8_t const* m_data=nullptr;
+// public:
+//         line_index()=default;
+//
+//         explicit line_index(char const* path):m_file(path)
+//         {
+//                 string_view f=m_file.view();
+//                 if(f.size()<sizeof(header)){
+//                         return;
+//                 }
+//                 auto h=reinterpret_cast<header const*>(f.data());
+//                 if(memcmp(h->magic, "LIDX", 4)!=0 || h->version!=version
+//                    || h->capacity>(f.size()-sizeof(header))/sizeof(block) || h->lines/per_block+(h->lines%per_block!=0)>h->capacity){
+//                         return;
+//                 }
+//                 auto blocks=reinterpret_cast<block const*>(h+1);
+//                 uint64_t data_size=f.size()-sizeof(header)-h->capacity*sizeof(block);
+//                 // 途中で切れた，壊れた索引を読んでend()がmmapの外を読まないよう，使うブロックの差の並びが全て収まっているか調べる
+//                 // 最後の埋まっていないブロックは，その行数分しか書かれていない
+//                 for(uint64_t i=0; i*per_block<h->lines; ++i){
+//                         block const& b=blocks[i];
+//                         uint64_t n=min<uint64_t>(h->lines-i*per_block, per_block);
+//                         if((b.width!=1 && b.width!=2 && b.width!=4 && b.width!=8) || b.data>data_size || n*b.width>data_size-b.data){
+//                                 return;
+//                         }
+//                 }
+//                 m_header=h;
+//                 m_blocks=blocks;
+//                 m_data=reinterpret_cast<uint8_t const*>(blocks+h->capacity);
+//         }
+//
+//         bool valid() const { return m_header; }
+//         size_t lines() const { return m_header ? m_header->lines : 0; }
+//         uint64_t indexed_size() const { return m_header ? m_header->indexed_size : 0; }
+//         uint64_t fingerprint() const { return m_header ? m_header->fingerprint : 0; }
+//         size_t capacity() const { return m_header ? m_header->capacity : 0; }
+//         block const* blocks() const { return m_blocks; }
+//         uint8_t const* data() const { return m_data; }
+//
+//         // n行目の終わり(改行の次)の位置
+//         uint64_t end(size_t n) const
+//         {
+//                 block const& b=m_blocks[n/per_block];
+//                 uint64_t d=0;
+//                 memcpy(&d, m_data+b.data+n%per_block*b.width, b.width);
+//                 return b.base+d;
+//         }
+//
+//         uint64_t begin(size_t n) const
+//         {
+//                 return n ? end(n-1) : 0;
+//         }
+//
+//         // 改行を含まないn行目
+//         string_view line(string_view text, size_t n) const
+//         {
+//                 uint64_t b=begin(n);
+//                 return text.substr(b, end(n)-b-1);
+//         }
+// };
+//
+// // 既存の索引の最後の埋まっていないブロック以降を作り，ファイルの該当する位置に書く
+// // ブロックの表が足りなくなった時だけ，表を2倍にしてファイル全体を書き直す
+// class line_index_writer{
+//         line_index const& m_old;
+//         size_t m_first; // 書き始めるブロック
+//         uint64_t m_data_begin; // 書き始める差の並びの位置
+//         vector<line_index::block> m_blocks;
+//         vector<uint8_t> m_data;
+//         vector<uint64_t> m_pending; // まだブロックにしていない行の終わりの位置
+//         uint64_t m_base=0;
+//         uint64_t m_lines;
+//
+//         void flush()
+//         {
+//                 if(m_pending.empty()){
+//                         return;
+//                 }
+//                 uint64_t max_delta=m_pending.back()-m_base;
+//                 uint32_t width=max_delta<(1u<<8) ? 1 : max_delta<(1u<<16) ? 2 : max_delta<(1ull<<32) ? 4 : 8;
+//                 m_blocks.push_back({m_base, m_data_begin+m_data.size(), width, 0});
+//                 for(uint64_t e: m_pending){
+//                         uint64_t d=e-m_base;
+//                         auto p=reinterpret_cast<uint8_t const*>(&d);
+//                         m_data.insert(m_data.end(), p, p+width);
+//                 }
+//                 m_base=m_pending.back();
+//                 m_pending.clear();
+//         }
+//
+//         bool rewrite(char const* path, line_index::header h)
+//         {
+//                 string tmp=string(path)+".tmp";
+//                 unique_ptr<FILE, int (*)(FILE*)> fp(fopen(tmp.c_str(), "wb"), &fclose);
+//                 if(!fp){
+//                         return false;
+//                 }
+//                 h.capacity=max<uint64_t>(2*(m_first+m_blocks.size()), 1024);
+//                 vector<line_index::block> unused(h.capacity-m_first-m_blocks.size());
+//                 fwrite(&h, sizeof(h), 1, fp.get());
+//                 if(m_first){
+//                         fwrite(m_old.blocks(), sizeof(line_index::block), m_first, fp.get());
+//                 }
+//                 fwrite(m_blocks.data(), sizeof(line_index::block), m_blocks.size(), fp.get());
+//                 fwrite(unused.data(), sizeof(line_index::block), unused.size(), fp.get());
+//                 if(m_first){
+//                         fwrite(m_old.data(), 1, m_data_begin, fp.get());
+//                 }
+//                 fwrite(m_data.data(), 1, m_data.size(), fp.get());
+//                 if(fclose(fp.release())!=0){
+//                         return false;
+//                 }
+//                 return rename(tmp.c_str(), path)==0; // 読んでいる側は古い索引をmmapしたまま使える
+//         }
+// public:
+//         explicit line_index_writer(line_index const& old):m_old{old}, m_first{old.lines()/line_index::per_block}, m_lines{m_first*line_index::per_block}
+//         {
+//                 m_data_begin=m_first ? old.blocks()[m_first-1].data+line_index::per_block*old.blocks()[m_first-1].width : 0;
+//                 m_base=m_first ? old.end(m_lines-1) : 0;
+//                 for(size_t n=m_lines; n<old.lines(); ++n){
+//                         add(old.end(n));
+//                 }
+//         }
+//
+//         void add(uint64_t end)
+//         {
+//                 m_pending.push_back(end);
+//                 ++m_lines;
+//                 if(m_pending.size()==line_index::per_block){
+//                         flush();
+//                 }
+//         }
+//
+//         // ヘッダは最後に書くので，途中で失敗しても古いヘッダの範囲は正しいまま
+//         // ただし最後の埋まっていないブロックは書き換えるので，更新中にその行を読んだ場合は壊れた値が見える
+//         bool write(char const* path, uint64_t indexed_size, uint64_t fingerprint)
+//         {
+//                 flush();
+//                 line_index::header h{{'L', 'I', 'D', 'X'}, line_index::version, m_lines, indexed_size, fingerprint, m_old.capacity()};
+//                 if(!m_old.valid() || m_first+m_blocks.size()>m_old.capacity()){
+//                         return rewrite(path, h);
+//                 }
+//                 int fd=open(path, O_WRONLY);
+//                 if(fd<0){
+//                         return false;
+//                 }
+//                 off_t data_start=sizeof(h)+h.capacity*sizeof(line_index::block);
+//                 bool ok=pwrite(fd, m_data.data(), m_data.size(), data_start+m_data_begin)==static_cast<ssize_t>(m_data.size())
+//                         && pwrite(fd, m_blocks.data(), m_blocks.size()*sizeof(line_index::block), sizeof(h)+m_first*sizeof(line_index::block))>=0
+//                         && pwrite(fd, &h, sizeof(h), 0)==sizeof(h);
+//                 return close(fd)==0 && ok;
+//         }
+// };
+//
+// // text_pathの索引をindex_pathに作るか更新し，走査したバイト数を返す
+// size_t update_line_index(char const* text_path, char const* index_path)
+// {
+//         mapped_file text(text_path);
+//         string_view t=text.view();
+//
+//         uint64_t from=0;
+//         line_index old(index_path);
+//         if(old.valid() && old.indexed_size()<=t.size() && old.fingerprint()==tail_fingerprint(t, old.indexed_size())){
+//                 from=old.indexed_size();
+//         }else{
+//                 old=line_index();
+//         }
+//
+//         line_index_writer writer(old);
+//         uint64_t indexed_size=from;
+//         for_each_newline(t.data()+from, t.size()-from, from, [&](uint64_t pos){ writer.add(pos+1); });
+//         if(size_t nl=t.rfind('\n'); nl!=string_view::npos && nl+1>from){
+//                 indexed_size=nl+1;
+//         }
+//         writer.write(index_path, indexed_size, tail_fingerprint(t, indexed_size));
+//         return t.size()-from;
+// }
+//
+// void bench_line_index(size_t mega_bytes)
+// {
+//         ifstream sample_ifs("sample.txt");
+//         string sample((istreambuf_iterator<char>(sample_ifs)), istreambuf_iterator<char>());
+//         auto append=[&](size_t bytes, size_t seed){
+//                 ofstream ofs("abc.txt", ios::app);
+//                 for(size_t size=0; size<bytes; ++seed){
+//                         string s=sample+to_string(seed)+'\n';
+//                         ofs << s;
+//                         size+=s.size();
+//                 }
+//         };
+//         remove("abc.txt");
+//         remove("abc.txt.idx");
+//         append(mega_bytes<<20, 0);
+//
+//         auto t0=chrono::steady_clock::now();
+//         update_line_index("abc.txt", "abc.txt.idx");
+//         auto t1=chrono::steady_clock::now();
+//         append(1<<20, 1987);
+//         auto t2=chrono::steady_clock::now();
+//         size_t scanned=update_line_index("abc.txt", "abc.txt.idx");
+//         auto t3=chrono::steady_clock::now();
+//
+//         mapped_file text("abc.txt");
+//         line_index index("abc.txt.idx");
+//         cout << "build: " << chrono::duration<double, milli>(t1-t0).count() << " ms, "
+//              << "incremental: " << chrono::duration<double, milli>(t3-t2).count() << " ms (" << scanned << " bytes scanned), "
+//              << index.lines() << " lines, " << static_cast<double>(ifstream("abc.txt.idx", ios::ate).tellg())/index.lines() << " bytes/line" << endl;
+//
+//         mt19937_64 gen(1987);
+//         int const queries=100'000;
+//         size_t total=0;
+//         auto t4=chrono::steady_clock::now();
+//         for(int i=0; i<queries; ++i){
+//                 total+=index.line(text.view(), gen()%index.lines()).size();
+//         }
+//         auto t5=chrono::steady_clock::now();
+//
+//         int const scans=5;
+//         int mismatches=0;
+//         for(int i=0; i<scans; ++i){
+//                 size_t n=gen()%index.lines();
+//                 ifstream ifs("abc.txt");
+//                 string str;
+//                 for(size_t k=0; k<=n; ++k){
+//                         getline(ifs, str);
+//                 }
+//                 mismatches+=str!=index.line(text.view(), n);
+//         }
+//         auto t6=chrono::steady_clock::now();
+//
+//         cout << "index:   " << chrono::duration<double, nano>(t5-t4).count()/queries << " ns/line (" << total << ")" << '\n';
+//         cout << "getline: " << chrono::duration<double, nano>(t6-t5).count()/scans << " ns/line"
+//              << (mismatches ? " (mismatch)" : "") << endl;
+// }
+
+
+/**
+ * 追記され続けるファイルの増えた行だけを処理したい(tail -F)
+ * [fstream],[thread.thread.this]
+ */
+// // ログのように1日中伸び続けるファイルを，上の例のようにgetlineで先頭から読み直すと，更新の度にファイル全体を読むことになる
+// // ・どこまで処理したか(最後の完全な行の次の位置)を覚えておき，次はそこからpreadで読む
+// //   最後の改行より後の書きかけの行は処理せず，次に改行が来た時に読み直す
+// // ・inotifyでファイルの変更を待つので，何も書かれない間はCPUを使わない
+// // ・切り詰められた(copytruncate)場合は，ファイルが処理済みの位置より小さくなるので先頭から読み直す
+// //   気付く前に処理済みの位置を超えて書かれると検出できないが，inotifyで直ぐに起こされるので通常は間に合う
+// // ・ローテーション(rename後に同じ名前で作り直す)は，ディレクトリの監視とinode番号の比較で検出する
+// //   古いファイルを最後まで読んでから，新しいファイルを先頭から読む
+// class line_follower{
+//         string m_path;
+//         int m_inotify;
+//         int m_fd=-1;
+//         ino_t m_ino=0;
+//         uint64_t m_offset=0;
+//         vector<char> m_buf=vector<char>(64*1024);
+//
+//         void reopen()
+//         {
+//                 if(m_fd>=0){
+//                         close(m_fd);
+//                 }
+//                 m_fd=open(m_path.c_str(), O_RDONLY);
+//                 struct stat st;
+//                 m_ino=m_fd>=0 && fstat(m_fd, &st)==0 ? st.st_ino : 0;
+//         }
+//
+//         // 処理済みの位置から最後の改行までを読み，完全な行ごとにfを呼ぶ
+//         template<typename F>
+//         size_t drain(F& f)
+//         {
+//                 size_t lines=0;
+//                 if(m_fd<0){
+//                         return 0;
+//                 }
+//                 trace::scope s("follow drain");
+//                 struct stat st;
+//                 if(fstat(m_fd, &st)==0 && static_cast<uint64_t>(st.st_size)<m_offset){
+//                         m_offset=0; // 切り詰められた
+//                 }
+//                 for(;;){
+//                         ssize_t n=pread(m_fd, m_buf.data(), m_buf.size(), m_offset);
+//                         if(n<=0){
+//                                 return lines;
+//                         }
+//                         string_view data(m_buf.data(), n);
+//                         size_t last=data.rfind('\n');
+//                         if(last==string_view::npos){
+//                                 if(static_cast<size_t>(n)==m_buf.size()){
+//                                         m_buf.resize(m_buf.size()*2); // 1行がバッファより長い
+//                                         continue;
+//                                 }
+//                                 return lines; // 書きかけの行だけ
+//                         }
+//                         for_each_line(data.substr(0, last+1), [&](string_view line){
+//                                 f(line);
+//                                 ++lines;
+//                         });
+//                         m_offset+=last+1; // ここまで処理した
+//                 }
+//         }
+//
+//         bool rotated() const
+//         {
+//                 struct stat st;
+//                 return stat(m_path.c_str(), &st)==0 && st.st_ino!=m_ino;
+//         }
+// public:
+//         // from_endなら既存の内容は読まずに，これから追記される行だけを処理する
+//         // offsetに前回のoffset()を渡すと，その続きから処理する
+//         explicit line_follower(string path, bool from_end=false, uint64_t offset=0):m_path{move(path)}, m_inotify{inotify_init1(IN_NONBLOCK|IN_CLOEXEC)}, m_offset{offset}
+//         {
+//                 // ファイルそのものではなくディレクトリを監視すると，作り直された新しいファイルへの書き込みも届く
+//                 size_t slash=m_path.rfind('/');
+//                 string dir=slash==string::npos ? "." : m_path.substr(0, slash+1);
+//                 inotify_add_watch(m_inotify, dir.c_str(), IN_MODIFY|IN_CREATE|IN_MOVED_TO|IN_CLOSE_WRITE);
+//                 reopen();
+//                 struct stat st;
+//                 if(from_end && m_fd>=0 && fstat(m_fd, &st)==0){
+//                         m_offset=st.st_size;
+//                 }
+//         }
+//
+//         line_follower(line_follower const&)=delete;
+//         line_follower& operator=(line_follower const&)=delete;
+//
+//         ~line_follower()
+//         {
+//                 if(m_fd>=0){
+//                         close(m_fd);
+//                 }
+//                 close(m_inotify);
+//         }
+//
+//         uint64_t offset() const
+//         {
+//                 return m_offset;
+//         }
+//
+//         // 新しく追記された行ごとにfを呼ぶ，何も無ければtimeout_msまで待つ
+//         template<typename F>
+//         size_t poll(F f, int timeout_ms)
+//         {
+//                 size_t lines=drain(f);
+//                 if(lines==0){
+//                         trace::scope s("follow wait");
+//                         pollfd pfd{m_inotify, POLLIN, 0};
+//                         ::poll(&pfd, 1, timeout_ms);
+//                 }
+//                 // 溜まったイベントは読み捨てる，どのイベントでも処理は同じ
+//                 alignas(inotify_event) char events[4096];
+//                 while(read(m_inotify, events, sizeof(events))>0){
+//                 }
+//
+//                 lines+=drain(f);
+//                 if(m_fd<0 || rotated()){
+//                         reopen(); // 古いファイルは読み終えている
+//                         m_offset=0;
+//                         lines+=drain(f);
+//                 }
+//                 return lines;
+//         }
+// };
+//
+// // 書き込む側は1行ごとに書いた時刻を書き，読む側で処理した時刻との差(追記から処理までの遅延)を測る
+// // 途中でローテーションと切り詰めを1回ずつ行う
+// void bench_follow(int total_lines)
+// {
+//         remove("abc.txt");
+//         remove("abc.txt.1");
+//         ofstream("abc.txt");
+//         line_follower follower("abc.txt");
+//
+//         atomic<bool> done{false};
+//         thread writer([&]{
+//                 auto ofs=make_unique<ofstream>("abc.txt", ios::app);
+//                 for(int i=0; i<total_lines; ++i){
+//                         if(i==total_lines/3){
+//                                 ofs.reset();
+//                                 rename("abc.txt", "abc.txt.1");
+//                                 ofs=make_unique<ofstream>("abc.txt");
+//                         }else if(i==2*total_lines/3){
+//                                 ofs=make_unique<ofstream>("abc.txt", ios::trunc);
+//                         }
+//                         auto now=chrono::steady_clock::now().time_since_epoch();
+//                         *ofs << "hoge " << chrono::duration_cast<chrono::nanoseconds>(now).count() << '\n' << flush;
+//                         this_thread::sleep_for(chrono::microseconds(500));
+//                 }
+//                 this_thread::sleep_for(chrono::milliseconds(100));
+//                 done=true;
+//         });
+//
+//         vector<double> latencies;
+//         while(!done){
+//                 follower.poll([&](string_view line){
+//                         long long sent=0;
+//                         from_chars(line.data()+5, line.data()+line.size(), sent);
+//                         auto now=chrono::steady_clock::now().time_since_epoch();
+//                         latencies.push_back((chrono::duration_cast<chrono::nanoseconds>(now).count()-sent)/1e3);
+//                 }, 50);
+//         }
+//         writer.join();
+//
+//         sort(latencies.begin(), latencies.end());
+//         auto pct=[&](double p){ return latencies.empty() ? 0.0 : latencies[static_cast<size_t>(p*(latencies.size()-1))]; };
+//         cout << latencies.size() << "/" << total_lines << " lines, latency p50 " << pct(0.5) << " us, p99 " << pct(0.99)
+//              << " us, max " << pct(1.0) << " us" << endl;
+// }
+
+
+/**
+ * UTF-8のテキストを高速に検証し，UTF-16/UTF-32と相互に変換したい
+ * [lex.charset],[basic.fundamental]
+ */
+// // このファイルのように日本語の多いUTF-8のテキストを1バイトずつ状態遷移で検証すると，取り込みの時間の多くを占める
+// // ・検証はSSSE3のpshufbで表を引き，16バイトを同時に調べる(Keiser, Lemireの方法)
+// //   各バイトについて「1つ前のバイトの上位4ビット」「1つ前のバイトの下位4ビット」「そのバイトの上位4ビット」で
+// //   3つの表を引き，ANDした結果が0でなければ，そのバイトと1つ前のバイトの組み合わせが誤り(短い，長い，冗長，サロゲート，範囲外)
+// //   3，4バイト文字の3，4バイト目は，2，3バイト前の先頭バイトから継続バイトでなければならないことを別に確かめる
+// //   ASCIIだけのブロックは表を引かない
+// // ・既定のx86-64(-march=nativeなどを付けない)では__SSSE3__が定義されないので，SSSE3を使う関数にだけ
+// //   __attribute__((target("ssse3")))を付けてコンパイルし，実行時にCPUが対応しているか調べて呼び分ける
+// //   対応していなければ8バイトずつASCIIを飛ばす1文字ずつの検証になる
+// // ・改行はASCIIなので，正しいテキストでは文字が行を跨がない
+// //   行ごとに検証しても，ブロックの途中で切れた文字を次のブロックに持ち越すutf8_validatorで任意の区切りのまま検証してもよい
+// //   短い行が多いと1回の呼び出しの固定費が効くので，読み込んだブロックごとにutf8_validatorへ渡す方が速い
+// // ・変換は検証済みの入力を前提にし，ASCIIの続く所と3バイト文字(U+0800〜U+FFFF)の続く所をSIMDで変換する
+// //   2バイト文字と4バイト文字は1文字ずつ
+// //   UTF-16/32からの変換は対になっていないサロゲートや範囲外の値を見つけるとsize_t(-1)を返す
+// inline bool utf8_valid_scalar(char const* s, size_t n)
+// {
+//         auto p=reinterpret_cast<unsigned char const*>(s);
+//         auto cont=[&](size_t i){ return (p[i]&0xC0)==0x80; };
+//         for(size_t i=0; i<n; ){
+//                 uint64_t w;
+//                 if(i+8<=n && (memcpy(&w, p+i, 8), (w&0x8080808080808080)==0)){
+//                         i+=8;
+//                         continue;
+//                 }
+//                 unsigned c=p[i];
+//                 if(c<0x80){
+//                         i+=1;
+//                 }else if(c<0xC2){
+//                         return false; // 継続バイトか，2バイトで書ける冗長な表現
+//                 }else if(c<0xE0){
+//                         if(i+1>=n || !cont(i+1)){
+//                                 return false;
+//                         }
+//                         i+=2;
+//                 }else if(c<0xF0){
+//                         if(i+2>=n || !cont(i+1) || !cont(i+2) || (c==0xE0 && p[i+1]<0xA0) || (c==0xED && p[i+1]>=0xA0)){
+//                                 return false; // 冗長な表現かサロゲート
+//                         }
+//                         i+=3;
+//                 }else if(c<0xF5){
+//                         if(i+3>=n || !cont(i+1) || !cont(i+2) || !cont(i+3) || (c==0xF0 && p[i+1]<0x90) || (c==0xF4 && p[i+1]>=0x90)){
+//                                 return false; // 冗長な表現かU+10FFFFより大きい
+//                         }
+//                         i+=4;
+//                 }else{
+//                         return false;
+//                 }
+//         }
+//         return true;
+// }
+//
+// inline bool has_ssse3()
+// {
+// #if defined(__x86_64__) && defined(__GNUC__)
+//         static bool const supported=[]{
+//                 __builtin_cpu_init();
+//                 return __builtin_cpu_supports("ssse3")!=0;
+//         }();
+//         return supported;
+// #else
+//         return false;
+// #endif
+// }
+//
+// #if defined(__x86_64__) && defined(__GNUC__)
+// class utf8_checker{
+//         __m128i m_error=_mm_setzero_si128();
+//         __m128i m_prev=_mm_setzero_si128();
+//         __m128i m_prev_incomplete=_mm_setzero_si128();
+//
+//         static __m128i high_nibble(__m128i v)
+//         {
+//                 return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+//         }
+// public:
+//         __attribute__((target("ssse3"))) void check(__m128i in)
+//         {
+//                 if(_mm_movemask_epi8(in)==0){
+//                         m_error=_mm_or_si128(m_error, m_prev_incomplete); // 前のブロックの末尾の文字が終わっていない
+//                         m_prev=in;
+//                         m_prev_incomplete=_mm_setzero_si128();
+//                         return;
+//                 }
+//                 constexpr char too_short=1<<0, too_long=1<<1, overlong_3=1<<2, too_large=1<<3,
+//                                surrogate=1<<4, overlong_2=1<<5, too_large_1000=1<<6, overlong_4=1<<6;
+//                 constexpr char two_conts=static_cast<char>(1<<7), carry=too_short|too_long|two_conts;
+//
+//                 __m128i prev1=_mm_alignr_epi8(in, m_prev, 15);
+//                 __m128i byte_1_high=_mm_shuffle_epi8(_mm_setr_epi8(
+//                         too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+//                         two_conts, two_conts, two_conts, two_conts,
+//                         too_short|overlong_2, too_short, too_short|overlong_3|surrogate, too_short|too_large|too_large_1000|overlong_4), high_nibble(prev1));
+//                 __m128i byte_1_low=_mm_shuffle_epi8(_mm_setr_epi8(
+//                         carry|overlong_3|overlong_2|overlong_4, carry|overlong_2, carry, carry,
+//                         carry|too_large, carry|too_large|too_large_1000, carry|too_large|too_large_1000, carry|too_large|too_large_1000,
+//                         carry|too_large|too_large_1000, carry|too_large|too_large_1000, carry|too_large|too_large_1000, carry|too_large|too_large_1000,
+//                         carry|too_large|too_large_1000, carry|too_large|too_large_1000|surrogate, carry|too_large|too_large_1000, carry|too_large|too_large_1000),
+//                         _mm_and_si128(prev1, _mm_set1_epi8(0x0F)));
+//                 __m128i byte_2_high=_mm_shuffle_epi8(_mm_setr_epi8(
+//                         too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+//                         too_long|overlong_2|two_conts|overlong_3|too_large_1000|overlong_4, too_long|overlong_2|two_conts|overlong_3|too_large,
+//                         too_long|overlong_2|two_conts|surrogate|too_large, too_long|overlong_2|two_conts|surrogate|too_large,
+//                         too_short, too_short, too_short, too_short), high_nibble(in));
+//                 __m128i special=_mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+//
+//                 // 2つ前が3，4バイト文字の先頭か，3つ前が4バイト文字の先頭なら継続バイトでなければならない
+//                 // (上の表では2つの継続バイトの並びをtwo_contsとしているので，それと打ち消し合う)
+//                 __m128i third=_mm_subs_epu8(_mm_alignr_epi8(in, m_prev, 14), _mm_set1_epi8(static_cast<char>(0xE0-0x80)));
+//                 __m128i fourth=_mm_subs_epu8(_mm_alignr_epi8(in, m_prev, 13), _mm_set1_epi8(static_cast<char>(0xF0-0x80)));
+//                 __m128i must23=_mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+//                 m_error=_mm_or_si128(m_error, _mm_xor_si128(must23, special));
+//
+//                 // 末尾の3バイトに，ブロック内で終わらない文字の先頭があるか
+//                 m_prev_incomplete=_mm_subs_epu8(in, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+//                                                                    static_cast<char>(0xF0-1), static_cast<char>(0xE0-1), static_cast<char>(0xC0-1)));
+//                 m_prev=in;
+//         }
+//
+//         bool finish()
+//         {
+//                 __m128i e=_mm_or_si128(m_error, m_prev_incomplete);
+//                 return _mm_movemask_epi8(_mm_cmpeq_epi8(e, _mm_setzero_si128()))==0xFFFF;
+//         }
+// };
+//
+// __attribute__((target("ssse3"))) inline bool utf8_valid_ssse3(char const* s, size_t n)
+// {
+//         utf8_checker checker;
+//         size_t i=0;
+//         for(; i+32<=n; i+=32){
+//                 __m128i a=_mm_loadu_si128(reinterpret_cast<__m128i const*>(s+i));
+//                 __m128i b=_mm_loadu_si128(reinterpret_cast<__m128i const*>(s+i+16));
+//                 checker.check(a);
+//                 checker.check(b);
+//         }
+//         for(; i<n; i+=16){
+//                 char tail[16]={}; // 残りは0(ASCII)で埋める
+//                 memcpy(tail, s+i, min<size_t>(16, n-i));
+//                 checker.check(_mm_loadu_si128(reinterpret_cast<__m128i const*>(tail)));
+//         }
+//         return checker.finish();
+// }
+// #endif
+//
+// inline bool utf8_valid(char const* s, size_t n)
+// {
+// #if defined(__x86_64__) && defined(__GNUC__)
+//         if(has_ssse3()){
+//                 return utf8_valid_ssse3(s, n);
+//         }
+// #endif
+//         return utf8_valid_scalar(s, n);
+// }
+//
+// inline bool utf8_valid(string_view s)
+// {
+//         return utf8_valid(s.data(), s.size());
+// }
+//
+// // 任意の位置で区切られたブロックを順に検証する
+// class utf8_validator{
+//         char m_carry[4];
+//         size_t m_carry_size=0;
+//         bool m_ok=true;
+//
+//         static size_t sequence_length(unsigned char c)
+//         {
+//                 return c>=0xF0 ? 4 : c>=0xE0 ? 3 : c>=0xC0 ? 2 : 1;
+//         }
+//
+//         // 末尾の終わっていない文字のバイト数(0〜3)
+//         static size_t incomplete_tail(string_view s)
+//         {
+//                 for(size_t k=1; k<=3 && k<=s.size(); ++k){
+//                         auto c=static_cast<unsigned char>(s[s.size()-k]);
+//                         if((c&0xC0)!=0x80){
+//                                 return sequence_length(c)>k ? k : 0;
+//                         }
+//                 }
+//                 return 0;
+//         }
+// public:
+//         bool feed(string_view s)
+//         {
+//                 if(!m_ok){
+//                         return false;
+//                 }
+//                 if(m_carry_size){
+//                         size_t need=sequence_length(m_carry[0]);
+//                         size_t take=min(need-m_carry_size, s.size());
+//                         memcpy(m_carry+m_carry_size, s.data(), take);
+//                         m_carry_size+=take;
+//                         s.remove_prefix(take);
+//                         if(m_carry_size<need){
+//                                 return true;
+//                         }
+//                         m_carry_size=0;
+//                         if(!(m_ok=utf8_valid(m_carry, need))){
+//                                 return false;
+//                         }
+//                 }
+//                 size_t tail=incomplete_tail(s);
+//                 m_ok=utf8_valid(s.data(), s.size()-tail);
+//                 memcpy(m_carry, s.data()+s.size()-tail, tail);
+//                 m_carry_size=tail;
+//                 return m_ok;
+//         }
+//
+//         // 最後のブロックの後に呼ぶ
+//         bool finish() const
+//         {
+//                 return m_ok && m_carry_size==0;
+//         }
+// };
+//
+// #if defined(__x86_64__) && defined(__GNUC__)
+// // 3バイト文字(日本語の大部分)を4つずつ，32ビットの要素に並べ替えてからビットを詰める
+// // 入力は後ろに16バイト以上ある所から始め，先頭から続く3バイト文字を変換した数を返す
+// template<typename Char>
+// __attribute__((target("ssse3"))) size_t utf8_3byte_ssse3(unsigned char const* p, size_t n, Char* out)
+// {
+//         __m128i const mask=_mm_setr_epi8(-16, -64, -64, -16, -64, -64, -16, -64, -64, -16, -64, -64, 0, 0, 0, 0);
+//         __m128i const lead=_mm_setr_epi8(-32, -128, -128, -32, -128, -128, -32, -128, -128, -32, -128, -128, 0, 0, 0, 0);
+//         __m128i const gather=_mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+//         size_t chars=0;
+//         for(size_t i=0; i+16<=n; i+=12, out+=4, chars+=4){
+//                 __m128i v=_mm_loadu_si128(reinterpret_cast<__m128i const*>(p+i));
+//                 __m128i x=_mm_shuffle_epi8(v, gather); // 要素ごとに 3バイト目，2バイト目，1バイト目，0
+//                 __m128i cp=_mm_or_si128(_mm_or_si128(_mm_and_si128(x, _mm_set1_epi32(0x3F)),
+//                                                      _mm_and_si128(_mm_srli_epi32(x, 2), _mm_set1_epi32(0xFC0))),
+//                                         _mm_and_si128(_mm_srli_epi32(x, 4), _mm_set1_epi32(0xF000)));
+//                 if constexpr(sizeof(Char)==2){
+//                         _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(cp, _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1)));
+//                 }else{
+//                         _mm_storeu_si128(reinterpret_cast<__m128i*>(out), cp);
+//                 }
+//                 if(unsigned m=~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, mask), lead))&0xFFF){
+//                         return chars+__builtin_ctz(m)/3; // 先頭から続く3バイト文字の数
+//                 }
+//         }
+//         return chars;
+// }
+//
+// // U+0800〜U+FFFF(サロゲートを除く)を4要素ずつ，要素ごとに3バイトを作って12バイトに詰める
+// // 16バイト書くので，後ろにまだ4要素(4バイト以上)ある時だけ進め，先頭から続く3バイトになる要素を変換した数を返す
+// template<typename Char>
+// __attribute__((target("ssse3"))) size_t utf16_or_32_3byte_ssse3(Char const* p, size_t n, char* out)
+// {
+//         __m128i const zero=_mm_setzero_si128();
+//         size_t i=0;
+//         for(; i+8<=n; i+=4, out+=12){
+//                 __m128i x;
+//                 if constexpr(sizeof(Char)==2){
+//                         x=_mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(p+i)), zero);
+//                 }else{
+//                         x=_mm_loadu_si128(reinterpret_cast<__m128i const*>(p+i));
+//                 }
+//                 __m128i b0=_mm_or_si128(_mm_srli_epi32(x, 12), _mm_set1_epi32(0xE0));
+//                 __m128i b1=_mm_or_si128(_mm_and_si128(_mm_slli_epi32(x, 2), _mm_set1_epi32(0x3F00)), _mm_set1_epi32(0x8000));
+//                 __m128i b2=_mm_or_si128(_mm_and_si128(_mm_slli_epi32(x, 16), _mm_set1_epi32(0x3F0000)), _mm_set1_epi32(0x800000));
+//                 __m128i bytes=_mm_or_si128(_mm_or_si128(b0, b1), b2);
+//                 _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(bytes, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1)));
+//                 __m128i small=_mm_cmpeq_epi32(_mm_srli_epi32(x, 11), zero);
+//                 __m128i large=_mm_xor_si128(_mm_cmpeq_epi32(_mm_srli_epi32(x, 16), zero), _mm_set1_epi32(-1));
+//                 __m128i surrogate=_mm_cmpeq_epi32(_mm_srli_epi32(x, 11), _mm_set1_epi32(0xD800>>11));
+//                 if(unsigned m=_mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(_mm_or_si128(small, large), surrogate)))){
+//                         return i+__builtin_ctz(m);
+//                 }
+//         }
+//         return i;
+// }
+// #endif
+//
+// // 以下の変換は検証済みのUTF-8を受け取り，書いた要素数を返す(outにはn要素分の領域が要る)
+// // SIMDの部分は常にブロック全体を書き，条件を満たさない要素があれば，その手前までだけ進める(残りは次に上書きされる)
+// // 入力が後ろに16バイトある時だけなので，書き込みは領域を越えない
+// template<typename Char>
+// size_t utf8_to_utf16_or_32(char const* s, size_t n, Char* out)
+// {
+//         static_assert(sizeof(Char)==2 || sizeof(Char)==4);
+//         auto p=reinterpret_cast<unsigned char const*>(s);
+//         Char* const start=out;
+//         for(size_t i=0; i<n; ){
+//                 unsigned c=p[i];
+// #ifdef __SSE2__
+//                 if(c<0x80 && i+16<=n){
+//                         // ASCIIを16バイトずつ広げる
+//                         __m128i const zero=_mm_setzero_si128();
+//                         for(; i+16<=n; i+=16, out+=16){
+//                                 __m128i v=_mm_loadu_si128(reinterpret_cast<__m128i const*>(p+i));
+//                                 __m128i lo=_mm_unpacklo_epi8(v, zero), hi=_mm_unpackhi_epi8(v, zero);
+//                                 if constexpr(sizeof(Char)==2){
+//                                         _mm_storeu_si128(reinterpret_cast<__m128i*>(out), lo);
+//                                         _mm_storeu_si128(reinterpret_cast<__m128i*>(out+8), hi);
+//                                 }else{
+//                                         _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(lo, zero));
+//                                         _mm_storeu_si128(reinterpret_cast<__m128i*>(out+4), _mm_unpackhi_epi16(lo, zero));
+//                                         _mm_storeu_si128(reinterpret_cast<__m128i*>(out+8), _mm_unpacklo_epi16(hi, zero));
+//                                         _mm_storeu_si128(reinterpret_cast<__m128i*>(out+12), _mm_unpackhi_epi16(hi, zero));
+//                                 }
+//                                 if(unsigned m=_mm_movemask_epi8(v)){
+//                                         i+=__builtin_ctz(m);
+//                                         out+=__builtin_ctz(m);
+//                                         break;
+//                                 }
+//                         }
+//                         continue;
+//                 }
+// #if defined(__x86_64__) && defined(__GNUC__)
+//                 if(c>=0xE0 && c<0xF0 && i+16<=n && has_ssse3()){
+//                         if(size_t chars=utf8_3byte_ssse3(p+i, n-i, out)){
+//                                 i+=3*chars;
+//                                 out+=chars;
+//                                 continue;
+//                         }
+//                 }
+// #endif
+// #endif
+//                 char32_t cp;
+//                 if(c<0x80){
+//                         cp=c;
+//                         i+=1;
+//                 }else if(c<0xE0){
+//                         cp=(c&0x1F)<<6|(p[i+1]&0x3F);
+//                         i+=2;
+//                 }else if(c<0xF0){
+//                         cp=(c&0x0F)<<12|(p[i+1]&0x3F)<<6|(p[i+2]&0x3F);
+//                         i+=3;
+//                 }else{
+//                         cp=(c&0x07)<<18|(p[i+1]&0x3F)<<12|(p[i+2]&0x3F)<<6|(p[i+3]&0x3F);
+//                         i+=4;
+//                 }
+//                 if(sizeof(Char)==2 && cp>=0x10000){
+//                         *out++=static_cast<Char>(0xD800+((cp-0x10000)>>10));
+//                         *out++=static_cast<Char>(0xDC00+(cp&0x3FF));
+//                 }else{
+//                         *out++=static_cast<Char>(cp);
+//                 }
+//         }
+//         return out-start;
+// }
+//
+// // UTF-16かUTF-32からUTF-8へ，outには4n(UTF-16なら3n)バイト分の領域が要る
+// template<typename Char>
+// size_t utf16_or_32_to_utf8(Char const* p, size_t n, char* out)
+// {
+//         static_assert(sizeof(Char)==2 || sizeof(Char)==4);
+//         char* const start=out;
+//         for(size_t i=0; i<n; ){
+// #ifdef __SSE2__
+//                 // 4要素ずつ32ビットに広げて調べる
+//                 auto load4=[&](size_t k){
+//                         if constexpr(sizeof(Char)==2){
+//                                 return _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(p+k)), _mm_setzero_si128());
+//                         }else{
+//                                 return _mm_loadu_si128(reinterpret_cast<__m128i const*>(p+k));
+//                         }
+//                 };
+//                 __m128i const zero=_mm_setzero_si128();
+//                 if(p[i]<0x80 && i+8<=n){
+//                         // ASCIIを8要素ずつ縮める
+//                         for(; i+8<=n; i+=8, out+=8){
+//                                 __m128i a=load4(i), b=load4(i+4);
+//                                 // ASCIIでない要素は0x80にしてから縮める
+//                                 __m128i ascii_a=_mm_cmpeq_epi32(_mm_and_si128(a, _mm_set1_epi32(~0x7F)), zero);
+//                                 __m128i ascii_b=_mm_cmpeq_epi32(_mm_and_si128(b, _mm_set1_epi32(~0x7F)), zero);
+//                                 a=_mm_or_si128(_mm_and_si128(ascii_a, a), _mm_andnot_si128(ascii_a, _mm_set1_epi32(0x80)));
+//                                 b=_mm_or_si128(_mm_and_si128(ascii_b, b), _mm_andnot_si128(ascii_b, _mm_set1_epi32(0x80)));
+//                                 __m128i w=_mm_packs_epi32(a, b);
+//                                 w=_mm_packus_epi16(w, w);
+//                                 _mm_storel_epi64(reinterpret_cast<__m128i*>(out), w);
+//                                 if(unsigned m=_mm_movemask_epi8(w)&0xFF){
+//                                         i+=__builtin_ctz(m);
+//                                         out+=__builtin_ctz(m);
+//                                         break;
+//                                 }
+//                         }
+//                         continue;
+//                 }
+// #if defined(__x86_64__) && defined(__GNUC__)
+//                 if(p[i]>=0x800 && i+8<=n && has_ssse3()){
+//                         if(size_t chars=utf16_or_32_3byte_ssse3(p+i, n-i, out)){
+//                                 i+=chars;
+//                                 out+=3*chars;
+//                                 continue;
+//                         }
+//                 }
+// #endif
+// #endif
+//                 char32_t cp=p[i++];
+//                 if(sizeof(Char)==2 && cp>=0xD800 && cp<0xE000){
+//                         if(cp>=0xDC00 || i==n || p[i]<0xDC00 || p[i]>=0xE000){
+//                                 return size_t(-1); // 対になっていないサロゲート
+//                         }
+//                         cp=0x10000+((cp-0xD800)<<10)+(p[i++]-0xDC00);
+//                 }else if(cp>0x10FFFF || (cp>=0xD800 && cp<0xE000)){
+//                         return size_t(-1);
+//                 }
+//                 if(cp<0x80){
+//                         *out++=static_cast<char>(cp);
+//                 }else if(cp<0x800){
+//                         *out++=static_cast<char>(0xC0|cp>>6);
+//                         *out++=static_cast<char>(0x80|(cp&0x3F));
+//                 }else if(cp<0x10000){
+//                         *out++=static_cast<char>(0xE0|cp>>12);
+//                         *out++=static_cast<char>(0x80|(cp>>6&0x3F));
+//                         *out++=static_cast<char>(0x80|(cp&0x3F));
+//                 }else{
+//                         *out++=static_cast<char>(0xF0|cp>>18);
+//                         *out++=static_cast<char>(0x80|(cp>>12&0x3F));
+//                         *out++=static_cast<char>(0x80|(cp>>6&0x3F));
+//                         *out++=static_cast<char>(0x80|(cp&0x3F));
+//                 }
+//         }
+//         return out-start;
+// }
+//
+// bool to_utf16(string_view s, u16string& out)
+// {
+//         if(!utf8_valid(s)){
+//                 return false;
+//         }
+//         out.resize(s.size());
+//         out.resize(utf8_to_utf16_or_32(s.data(), s.size(), out.data()));
+//         return true;
+// }
+//
+// bool to_utf32(string_view s, u32string& out)
+// {
+//         if(!utf8_valid(s)){
+//                 return false;
+//         }
+//         out.resize(s.size());
+//         out.resize(utf8_to_utf16_or_32(s.data(), s.size(), out.data()));
+//         return true;
+// }
+//
+// template<typename Char>
+// bool to_utf8(basic_string_view<Char> s, string& out)
+// {
+//         out.resize(s.size()*(sizeof(Char)==2 ? 3 : 4));
+//         size_t n=utf16_or_32_to_utf8(s.data(), s.size(), out.data());
+//         out.resize(n==size_t(-1) ? 0 : n);
+//         return n!=size_t(-1);
+// }
+//
+// // このファイル自身を繰り返したテキストで測る
+// void bench_utf8(size_t mega_bytes)
+// {
+//         ifstream ifs("study.cpp");
+//         string self((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+//         string text;
+//         while(text.size()<mega_bytes<<20){
+//                 text+=self;
+//         }
+//         auto gbps=[&](char const* name, auto f){
+//                 auto start=chrono::steady_clock::now();
+//                 bool ok=f();
+//                 chrono::duration<double> d=chrono::steady_clock::now()-start;
+//                 cout << name << text.size()/d.count()/(1<<30) << " GB/s" << (ok ? "" : " (failed)") << '\n';
+//         };
+//
+//         gbps("validate scalar      ", [&]{ return utf8_valid_scalar(text.data(), text.size()); });
+//         gbps("validate simd        ", [&]{ return utf8_valid(text); });
+//         gbps("validate per line    ", [&]{
+//                 bool ok=true;
+//                 for_each_line(text, [&](string_view line){ ok&=utf8_valid(line); });
+//                 return ok;
+//         });
+//         gbps("validate 4093B block ", [&]{
+//                 utf8_validator v;
+//                 for(size_t pos=0; pos<text.size(); pos+=4093){ // 文字の途中で切れるように半端な大きさにする
+//                         v.feed(string_view(text).substr(pos, 4093));
+//                 }
+//                 return v.finish();
+//         });
+//
+//         // 変換は確保済みの領域に書く時間を測る
+//         u16string u16(text.size(), 0);
+//         u32string u32(text.size(), 0);
+//         string back(text.size()*3, 0);
+//         size_t n16=0, n32=0, n8=0;
+//         gbps("utf-8 -> utf-16      ", [&]{ return (n16=utf8_to_utf16_or_32(text.data(), text.size(), u16.data()))>0; });
+//         gbps("utf-8 -> utf-32      ", [&]{ return (n32=utf8_to_utf16_or_32(text.data(), text.size(), u32.data()))>0; });
+//         gbps("utf-16 -> utf-8      ", [&]{ return (n8=utf16_or_32_to_utf8(u16.data(), n16, back.data()))==text.size(); });
+//         gbps("utf-32 -> utf-8      ", [&]{ return utf16_or_32_to_utf8(u32.data(), n32, back.data())==text.size(); });
+//
+//         u16string w16;
+//         u32string w32;
+//         string back16, back32;
+//         bool ok=to_utf16(text, w16) && to_utf32(text, w32) && to_utf8(u16string_view(w16), back16) && to_utf8(u32string_view(w32), back32);
+//         cout << "round trip " << boolalpha << (ok && back16==text && back32==text) << '\n';
+//
+//         // 誤りの例はどれも検出される
+//         for(string_view bad: {"\x80", "\xC0\xAF", "\xE0\x80\xAF", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xE3\x81", "\xE3\x81\x82\x82"}){
+//                 cout << utf8_valid(bad) << utf8_valid_scalar(bad.data(), bad.size());
+//         }
+//         cout << endl;
+// }
+
+
+/**
+ * mmapしたテキストから文字列を含む行を高速に探したい(grep)
+ * [string.view.find],[func.search.bmh]
+ */
+// // 1行ずつ取り出してからfindすると，行の切り出しと1行ごとの呼び出しの分だけ遅くなる
+// // mapped_fileの領域全体を直接検索し，見つかった位置から前後の改行を探してその行を得る
+// // ・1つのパターン: パターンの最初の文字と最後の文字を16バイトずつ同時に比較し，
+// //   両方が一致した位置だけmemcmpで確かめる(SIMDの最初/最後の文字フィルタ)
+// //   最初の文字だけで絞り込むmemchrに比べて，"aaaa"のような出現頻度の高い文字から始まるパターンでも候補が少ない
+// // ・複数のパターン: Aho-Corasick法の状態遷移表(DFA)を作り，1バイトにつき表を1回引くだけで全てのパターンを同時に探す
+// //   パターンの数に依らずテキストを1回走査するだけで済む
+// //   ただし表の参照は前の状態に依存するので1バイトずつしか進めない
+// //   初期状態にいる間は，パターンの先頭になり得る文字(8種類まではSIMDで比較)まで読み飛ばす
+// // どの検索器も find(first, last) で最初に一致した位置(無ければlast)を返す
+// class simd_searcher{
+//         string m_needle;
+// public:
+//         explicit simd_searcher(string_view needle):m_needle(needle){}
+//
+//         char const* find(char const* first, char const* last) const
+//         {
+//                 size_t const n=m_needle.size();
+//                 if(n<=1 || static_cast<size_t>(last-first)<n){
+//                         return n==0 ? first : std::search(first, last, m_needle.begin(), m_needle.end());
+//                 }
+//                 char const* p=first;
+// #ifdef __SSE2__
+//                 __m128i const head=_mm_set1_epi8(m_needle.front());
+//                 __m128i const tail=_mm_set1_epi8(m_needle.back());
+//                 for(; p+n-1+16<=last; p+=16){
+//                         __m128i a=_mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+//                         __m128i b=_mm_loadu_si128(reinterpret_cast<__m128i const*>(p+n-1));
+//                         auto m=static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, head), _mm_cmpeq_epi8(b, tail))));
+//                         for(; m; m&=m-1){
+//                                 char const* c=p+__builtin_ctz(m);
+//                                 if(memcmp(c+1, m_needle.data()+1, n-2)==0){
+//                                         return c;
+//                                 }
+//                         }
+//                 }
+// #endif
+//                 return std::search(p, last, m_needle.begin(), m_needle.end());
+//         }
+// };
+//
+// class aho_corasick{
+//         vector<array<int32_t, 256>> m_next; // 状態×バイト → 次の状態
+//         vector<int32_t> m_match; // その状態で終わるパターンのうち最も短いものの長さ，無ければ0
+//         array<bool, 256> m_start{}; // パターンの先頭の文字
+//         string m_starts;
+// #ifdef __SSE2__
+//         __m128i m_start_vec[8];
+// #endif
+//
+//         // 初期状態のまま進む文字を読み飛ばす
+//         char const* skip(char const* p, char const* last) const
+//         {
+//                 if(m_starts.empty()){
+//                         return last; // 空でないパターンが無いので，どこにも一致しない
+//                 }
+// #ifdef __SSE2__
+//                 if(m_starts.size()<=8){
+//                         for(; p+16<=last; p+=16){
+//                                 __m128i x=_mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+//                                 __m128i hit=_mm_cmpeq_epi8(x, m_start_vec[0]);
+//                                 for(size_t i=1; i<8; ++i){
+//                                         hit=_mm_or_si128(hit, _mm_cmpeq_epi8(x, m_start_vec[i]));
+//                                 }
+//                                 if(auto m=_mm_movemask_epi8(hit)){
+//                                         return p+__builtin_ctz(m);
+//                                 }
+//                         }
+//                 }
+// #endif
+//                 while(p!=last && !m_start[static_cast<unsigned char>(*p)]){
+//                         ++p;
+//                 }
+//                 return p;
+//         }
+// public:
+//         // 空のパターンは無視する
+//         explicit aho_corasick(vector<string> const& patterns)
+//         {
+//                 // 1. パターンのトライ木を作る，-1は辺が無いことを表す
+//                 m_next.emplace_back();
+//                 m_next[0].fill(-1);
+//                 m_match.push_back(0);
+//                 for(auto const& pat: patterns){
+//                         int32_t s=0;
+//                         for(unsigned char c: pat){
+//                                 if(m_next[s][c]<0){
+//                                         m_next[s][c]=static_cast<int32_t>(m_next.size());
+//                                         m_next.emplace_back();
+//                                         m_next.back().fill(-1);
+//                                         m_match.push_back(0);
+//                                 }
+//                                 s=m_next[s][c];
+//                         }
+//                         if(!pat.empty() && !m_start[static_cast<unsigned char>(pat[0])]){
+//                                 m_start[static_cast<unsigned char>(pat[0])]=true;
+//                                 m_starts+=pat[0];
+//                         }
+//                         m_match[s]=m_match[s] ? min<int32_t>(m_match[s], pat.size()) : pat.size();
+//                 }
+//
+// #ifdef __SSE2__
+//                 for(size_t i=0; i<8 && !m_starts.empty(); ++i){
+//                         m_start_vec[i]=_mm_set1_epi8(m_starts[i%m_starts.size()]); // 8種類に満たない分は繰り返して埋める
+//                 }
+// #endif
+//
+//                 // 2. 幅優先で失敗リンクを辿り，無い辺を埋めて完全なDFAにする
+//                 vector<int32_t> fail(m_next.size(), 0);
+//                 deque<int32_t> queue;
+//                 for(auto& t: m_next[0]){
+//                         if(t<0){
+//                                 t=0;
+//                         }else{
+//                                 queue.push_back(t);
+//                         }
+//                 }
+//                 while(!queue.empty()){
+//                         int32_t s=queue.front();
+//                         queue.pop_front();
+//                         if(!m_match[s]){
+//                                 m_match[s]=m_match[fail[s]]; // 接尾辞として含まれるパターン
+//                         }
+//                         for(int c=0; c<256; ++c){
+//                                 int32_t& t=m_next[s][c];
+//                                 if(t<0){
+//                                         t=m_next[fail[s]][c];
+//                                 }else{
+//                                         fail[t]=m_next[fail[s]][c];
+//                                         queue.push_back(t);
+//                                 }
+//                         }
+//                 }
+//         }
+//
+//         char const* find(char const* first, char const* last) const
+//         {
+//                 int32_t s=0;
+//                 for(char const* p=first; p!=last; ++p){
+//                         if(s==0 && (p=skip(p, last))==last){
+//                                 break;
+//                         }
+//                         s=m_next[s][static_cast<unsigned char>(*p)];
+//                         if(m_match[s]){
+//                                 return p+1-m_match[s];
+//                         }
+//                 }
+//                 return last;
+//         }
+// };
+//
+// // 比較用
+// struct find_searcher{
+//         string_view needle;
+//
+//         char const* find(char const* first, char const* last) const
+//         {
+//                 size_t pos=string_view(first, last-first).find(needle);
+//                 return pos==string_view::npos ? last : first+pos;
+//         }
+// };
+//
+// struct bmh_searcher{
+//         boyer_moore_horspool_searcher<char const*> searcher;
+//
+//         explicit bmh_searcher(string_view needle):searcher(needle.data(), needle.data()+needle.size()){}
+//
+//         char const* find(char const* first, char const* last) const
+//         {
+//                 return std::search(first, last, searcher);
+//         }
+// };
+//
+// // 複数のパターンをそれぞれfindし，最も前の位置を取る
+// struct multi_find_searcher{
+//         vector<string> patterns;
+//
+//         char const* find(char const* first, char const* last) const
+//         {
+//                 char const* found=last;
+//                 for(auto const& pat: patterns){
+//                         size_t pos=string_view(first, found-first).find(pat);
+//                         if(pos!=string_view::npos){
+//                                 found=first+pos;
+//                         }
+//                 }
+//                 return found;
+//         }
+// };
+//
+// // textの中で一致を含む行ごとにfを呼ぶ
+// template<typename Searcher, typename F>
+// size_t grep(string_view text, Searcher const& searcher, F f)
+// {
+//         char const* const begin=text.data();
+//         char const* const end=begin+text.size();
+//         size_t lines=0;
+//         for(char const* p=begin; p<end; ){
+//                 char const* m=searcher.find(p, end);
+//                 if(m==end){
+//                         break;
+//                 }
+//                 auto nl=static_cast<char const*>(memrchr(begin, '\n', m-begin));
+//                 char const* line_begin=nl ? nl+1 : begin;
+//                 auto line_end=static_cast<char const*>(memchr(m, '\n', end-m));
+//                 line_end=line_end ? line_end : end;
+//                 f(string_view(line_begin, line_end-line_begin));
+//                 ++lines;
+//                 p=line_end==end ? end : line_end+1; // 同じ行の2つ目以降の一致は探さない，最後の行に改行が無ければend+1を作らない
+//         }
+//         return lines;
+// }
+//
+// void bench_grep(size_t mega_bytes)
+// {
+//         ifstream ifs("sample.txt");
+//         string sample((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+//         {
+//                 ofstream ofs("abc.txt");
+//                 for(size_t i=0, size=0; size<mega_bytes<<20; ++i){
+//                         string s=sample+to_string(i*2654435761u%1'000'000)+'\n';
+//                         ofs << s;
+//                         size+=s.size();
+//                 }
+//         }
+//         mapped_file file("abc.txt");
+//         string_view text=file.view();
+//
+//         auto run=[&](char const* name, auto const& searcher){
+//                 size_t bytes=0;
+//                 auto start=chrono::steady_clock::now();
+//                 size_t lines=grep(text, searcher, [&](string_view line){ bytes+=line.size(); });
+//                 chrono::duration<double> d=chrono::steady_clock::now()-start;
+//                 cout << "  " << name << text.size()/d.count()/(1<<30) << " GB/s (" << lines << " lines, " << bytes << " bytes)" << '\n';
+//         };
+//
+//         for(string_view pat: {"fuga", "aaaaaaaaaaaaaa", "12345"}){
+//                 cout << '"' << pat << '"' << '\n';
+//                 run("string_view::find ", find_searcher{pat});
+//                 run("horspool          ", bmh_searcher(pat));
+//                 run("simd first/last   ", simd_searcher(pat));
+//         }
+//
+//         vector<string> few{"12345", "99999", "foobar", "hogehoge", "777777"};
+//         vector<string> many=few;
+//         many.insert(many.end(), {"piyo", "qux", "quux", "corge", "grault", "garply", "waldo", "fred", "plugh", "xyzzy", "thud"});
+//         for(auto const* patterns: {&few, &many}){
+//                 cout << patterns->size() << " patterns" << '\n';
+//                 run("find each         ", multi_find_searcher{*patterns});
+//                 run("aho-corasick      ", aho_corasick(*patterns));
+//         }
+//         cout << flush;
+// }
+
+
+/**
+ * 区切られた数値の列をまとめて高速に配列へ変換したい
+ * [charconv.from.chars],[lex.fcon]
+ */
+// // 上の例のように iss >> m >> f で1つずつ読むと，ロケールやストリームの状態の確認が値ごとに入る
+// // from_charsと同じ形の fast_from_chars を作り，それを使って行ごとに各列の配列へ追加する
+// // ・整数: 8バイトを1つのuint64_tとして読み，8桁の数字かどうかの判定と変換をそれぞれ数回の整数演算で行う(SWAR)
+// // ・浮動小数点数: 10進の仮数w(19桁まで)と指数qに分けてから2進に変換する
+// //   1. wとqが小さければ(doubleならw<=2^53，|q|<=22)，w*10^qの1回の演算で正しく丸められる(Clingerの高速経路)
+// //   2. それ以外はEisel-Lemire法で，5^qの上位128ビットとwの積から仮数と指数を直接求める
+// //      丸めが決まらない稀な場合と，20桁以上の仮数の場合はfrom_charsに任せる
+// // ・5^qの表は起動時に多倍長整数で計算する(fast_floatの表と同じ値になる)
+// // 丸めモードは既定(最近接偶数)，浮動小数点演算はSSE2で行われる(x87の拡張精度ではない)ことを前提にする
+// template<typename T>
+// struct binary_format;
+//
+// template<>
+// struct binary_format<double>{
+//         using bits=uint64_t;
+//         static constexpr int mantissa_bits=52;
+//         static constexpr int minimum_exponent=-1023;
+//         static constexpr int infinite_power=0x7ff;
+//         static constexpr int smallest_power_of_ten=-342;
+//         static constexpr int largest_power_of_ten=308;
+//         static constexpr int min_round_to_even=-4;
+//         static constexpr int max_round_to_even=23;
+//         static constexpr int max_fast_exponent=22;
+//         static constexpr uint64_t max_fast_mantissa=uint64_t{1}<<53;
+// };
+//
+// template<>
+// struct binary_format<float>{
+//         using bits=uint32_t;
+//         static constexpr int mantissa_bits=23;
+//         static constexpr int minimum_exponent=-127;
+//         static constexpr int infinite_power=0xff;
+//         static constexpr int smallest_power_of_ten=-65;
+//         static constexpr int largest_power_of_ten=38;
+//         static constexpr int min_round_to_even=-17;
+//         static constexpr int max_round_to_even=10;
+//         static constexpr int max_fast_exponent=10;
+//         static constexpr uint64_t max_fast_mantissa=uint64_t{1}<<24;
+// };
+//
+// // 5^q(q=-342〜308)を[2^127, 2^128)に正規化したもの，q<0では 2^b/5^-q に1を足して切り上げる
+// struct pow5_128{
+//         static constexpr int min_q=-342, max_q=308;
+//         uint64_t hi[max_q-min_q+1];
+//         uint64_t lo[max_q-min_q+1];
+// };
+//
+// pow5_128 const& pow5_table()
+// {
+//         static pow5_128 const table=[]{
+//                 using big=vector<uint64_t>; // 下位から64ビットずつ
+//                 auto bit_length=[](big const& x){
+//                         for(size_t i=x.size(); i-->0;){
+//                                 if(x[i]){
+//                                         return static_cast<int>(64*i+64-__builtin_clzll(x[i]));
+//                                 }
+//                         }
+//                         return 0;
+//                 };
+//                 auto mul=[](big& x, uint64_t m){
+//                         unsigned __int128 carry=0;
+//                         for(auto& limb: x){
+//                                 carry+=static_cast<unsigned __int128>(limb)*m;
+//                                 limb=static_cast<uint64_t>(carry);
+//                                 carry>>=64;
+//                         }
+//                         if(carry){
+//                                 x.push_back(static_cast<uint64_t>(carry));
+//                         }
+//                 };
+//                 auto div=[](big& x, uint64_t d){
+//                         unsigned __int128 rem=0;
+//                         for(size_t i=x.size(); i-->0;){
+//                                 rem=rem<<64|x[i];
+//                                 x[i]=static_cast<uint64_t>(rem/d);
+//                                 rem%=d;
+//                         }
+//                 };
+//                 // xの上位128ビット，128ビットに満たなければ左に詰める
+//                 auto top128=[&](big const& x, uint64_t& hi, uint64_t& lo){
+//                         int shift=bit_length(x)-128;
+//                         auto bit=[&](int i){ return i>=0 && x[i/64]>>(i%64)&1; };
+//                         hi=lo=0;
+//                         for(int i=127; i>=0; --i){
+//                                 (i>=64 ? hi : lo)|=static_cast<uint64_t>(bit(i+shift))<<(i%64);
+//                         }
+//                 };
+//
+//                 pow5_128 t;
+//                 big p{1};
+//                 for(int q=0; q<=pow5_128::max_q; ++q){
+//                         top128(p, t.hi[q-pow5_128::min_q], t.lo[q-pow5_128::min_q]);
+//                         mul(p, 5);
+//                 }
+//                 p={1};
+//                 for(int k=1; k<=-pow5_128::min_q; ++k){
+//                         mul(p, 5);
+//                         int z=bit_length(p); // 2^z>=5^k となる最小のz(5^kは2の冪ではない)
+//                         int b=k<=27 ? z+127 : 2*z+128;
+//                         big x(b/64+1);
+//                         x[b/64]=uint64_t{1}<<(b%64);
+//                         for(int i=0; i<k; ++i){
+//                                 div(x, 5); // floor(floor(a/5)/5)==floor(a/25)
+//                         }
+//                         for(size_t i=0; ++x[i]==0; ++i){ // +1
+//                         }
+//                         top128(x, t.hi[-k-pow5_128::min_q], t.lo[-k-pow5_128::min_q]);
+//                 }
+//                 return t;
+//         }();
+//         return table;
+// }
+//
+// // 仮数mantissa(先頭の1を除く)と，バイアスを足した2進の指数power2
+// struct adjusted_mantissa{
+//         uint64_t mantissa;
+//         int power2;
+// };
+//
+// // w*10^qを正しく丸めた値，丸めが決まらない場合はfalse
+// template<typename T>
+// bool eisel_lemire(uint64_t w, int64_t q, adjusted_mantissa& a)
+// {
+//         using F=binary_format<T>;
+//         if(q<F::smallest_power_of_ten){
+//                 a={0, 0};
+//                 return true;
+//         }
+//         if(q>F::largest_power_of_ten){
+//                 a={0, F::infinite_power};
+//                 return true;
+//         }
+//         int lz=__builtin_clzll(w);
+//         w<<=lz;
+//
+//         // 必要な精度は仮数+3ビットなので，上位64ビットの下位ビットが全て1でなければ2つ目の積は要らない
+//         pow5_128 const& table=pow5_table();
+//         int const index=static_cast<int>(q-pow5_128::min_q);
+//         uint64_t const precision_mask=~uint64_t{0}>>(F::mantissa_bits+3);
+//         auto first=static_cast<unsigned __int128>(w)*table.hi[index];
+//         auto high=static_cast<uint64_t>(first>>64), low=static_cast<uint64_t>(first);
+//         if((high&precision_mask)==precision_mask){
+//                 auto second=static_cast<uint64_t>((static_cast<unsigned __int128>(w)*table.lo[index])>>64);
+//                 low+=second;
+//                 high+=second>low;
+//         }
+//         if(low==~uint64_t{0} && (q<-27 || q>55)){
+//                 return false; // 128ビットでは足りない
+//         }
+//
+//         int upperbit=static_cast<int>(high>>63);
+//         int const shift=upperbit+64-F::mantissa_bits-3;
+//         a.mantissa=high>>shift;
+//         a.power2=static_cast<int>((((152170+65536)*q)>>16)+63+upperbit-lz-F::minimum_exponent); // floor(q*log2(10))+63+...
+//         if(a.power2<=0){ // 非正規化数
+//                 if(-a.power2+1>=64){
+//                         a={0, 0};
+//                         return true;
+//                 }
+//                 a.mantissa>>=-a.power2+1;
+//                 a.mantissa+=a.mantissa&1;
+//                 a.mantissa>>=1;
+//                 a.power2=a.mantissa<(uint64_t{1}<<F::mantissa_bits) ? 0 : 1;
+//                 return true;
+//         }
+//         // ちょうど中間の値は偶数側に丸める
+//         if(low<=1 && q>=F::min_round_to_even && q<=F::max_round_to_even && (a.mantissa&3)==1 && (a.mantissa<<shift)==high){
+//                 a.mantissa&=~uint64_t{1};
+//         }
+//         a.mantissa+=a.mantissa&1;
+//         a.mantissa>>=1;
+//         if(a.mantissa>=(uint64_t{2}<<F::mantissa_bits)){
+//                 a.mantissa=uint64_t{1}<<F::mantissa_bits;
+//                 ++a.power2;
+//         }
+//         a.mantissa&=~(uint64_t{1}<<F::mantissa_bits);
+//         if(a.power2>=F::infinite_power){
+//                 a={0, F::infinite_power};
+//         }
+//         return true;
+// }
+//
+// bool is_eight_digits(uint64_t v)
+// {
+//         return (((v&0xf0f0f0f0f0f0f0f0)|(((v+0x0606060606060606)&0xf0f0f0f0f0f0f0f0)>>4))==0x3333333333333333);
+// }
 //
-// cout << m << '\n';
-// cout << s << '\n';
-// cout << f << endl;
+// // "12345678"(リトルエンディアンで読んだもの)→12345678
+// uint32_t parse_eight_digits(uint64_t v)
+// {
+//         v-=0x3030303030303030;
+//         v=v*10+(v>>8); // 隣り合う2桁をまとめる
+//         v=(((v&0x000000ff000000ff)*0x000f424000000064)+(((v>>16)&0x000000ff000000ff)*0x0000271000000001))>>32;
+//         return static_cast<uint32_t>(v);
+// }
 //
-// // ostringstreamはsprintfに代替するもの
-// // 以下はsprintf(str, "%d %s %f", m, s, f)してるのと同じ
-// ostringstream oss;
-// oss << m << ' ' << s << ' ' << f;
+// bool is_digit(char c)
+// {
+//         return static_cast<unsigned char>(c-'0')<10;
+// }
 //
-// cout << oss.str() << endl;
+// // from_charsと同じ規則(先頭の'+'や空白は受け付けない)で，int32_t，int64_t，float，doubleを読む
+// template<typename T>
+// from_chars_result fast_from_chars(char const* first, char const* last, T& value)
+// {
+//         char const* p=first;
+//         bool const neg=p!=last && *p=='-';
+//         p+=neg;
+//         char const* const digits=p;
+//
+//         if constexpr(is_integral_v<T>){
+//                 uint64_t v=0;
+//                 for(uint64_t chunk; last-p>=8 && (memcpy(&chunk, p, 8), is_eight_digits(chunk)); p+=8){
+//                         v=v*100'000'000+parse_eight_digits(chunk);
+//                 }
+//                 for(; p!=last && is_digit(*p); ++p){
+//                         v=v*10+(*p-'0');
+//                 }
+//                 if(p==digits){
+//                         return {first, errc::invalid_argument};
+//                 }
+//                 if(p-digits>19){
+//                         return from_chars(first, last, value); // 先頭に0が並んでいる場合など
+//                 }
+//                 uint64_t const limit=neg ? uint64_t{numeric_limits<T>::max()}+1 : uint64_t{numeric_limits<T>::max()};
+//                 if(v>limit){
+//                         return {p, errc::result_out_of_range};
+//                 }
+//                 value=static_cast<T>(neg ? 0-v : v);
+//                 return {p, errc()};
+//         }else{
+//                 using F=binary_format<T>;
+//                 uint64_t w=0;
+//                 int64_t q=0;
+//                 int significant=0;
+//                 auto digit=[&](char c, int64_t scale){
+//                         if(significant==19){
+//                                 return false;
+//                         }
+//                         w=w*10+(c-'0');
+//                         significant+=w!=0;
+//                         q-=scale;
+//                         return true;
+//                 };
+//                 for(; p!=last && is_digit(*p); ++p){
+//                         if(!digit(*p, 0)){
+//                                 return from_chars(first, last, value);
+//                         }
+//                 }
+//                 if(p!=last && *p=='.'){
+//                         ++p;
+//                         for(uint64_t chunk; significant+8<=19 && last-p>=8 && (memcpy(&chunk, p, 8), is_eight_digits(chunk)); p+=8){
+//                                 w=w*100'000'000+parse_eight_digits(chunk);
+//                                 significant+=w ? 8 : 0; // 多めに数えても安全側になるだけ
+//                                 q-=8;
+//                         }
+//                         for(; p!=last && is_digit(*p); ++p){
+//                                 if(!digit(*p, 1)){
+//                                         return from_chars(first, last, value);
+//                                 }
+//                         }
+//                 }
+//                 if(p==digits || (p==digits+1 && *digits=='.')){
+//                         return from_chars(first, last, value); // infやnan，または数値ではない
+//                 }
+//                 if(p!=last && (*p|0x20)=='e'){
+//                         char const* e=p+1;
+//                         bool eneg=e!=last && *e=='-';
+//                         e+=eneg || (e!=last && *e=='+');
+//                         if(e!=last && is_digit(*e)){
+//                                 int64_t exp=0;
+//                                 for(; e!=last && is_digit(*e); ++e){
+//                                         exp=min<int64_t>(exp*10+(*e-'0'), 1'000'000);
+//                                 }
+//                                 q+=eneg ? -exp : exp;
+//                                 p=e;
+//                         }
+//                 }
+//
+//                 T v;
+//                 if(w==0){
+//                         v=0;
+//                 }else if(q>=-F::max_fast_exponent && q<=F::max_fast_exponent && w<=F::max_fast_mantissa){
+//                         static constexpr T pow10[]={1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+//                                                     1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+//                         v=q<0 ? static_cast<T>(w)/pow10[-q] : static_cast<T>(w)*pow10[q];
+//                 }else{
+//                         adjusted_mantissa a;
+//                         if(!eisel_lemire<T>(w, q, a)){
+//                                 return from_chars(first, last, value);
+//                         }
+//                         if(a.power2==F::infinite_power || (a.power2==0 && a.mantissa==0)){
+//                                 return {p, errc::result_out_of_range}; // from_charsと同じくvalueは変更しない
+//                         }
+//                         auto bits=static_cast<typename F::bits>(static_cast<typename F::bits>(a.power2)<<F::mantissa_bits|a.mantissa);
+//                         memcpy(&v, &bits, sizeof(v));
+//                 }
+//                 value=neg ? -v : v;
+//                 return {p, errc()};
+//         }
+// }
+//
+// // [first, last)を1行ずつ読み，delimで区切った各列をcolsに追加する
+// // 最後の改行の無い行や解析できない行があれば，その行の先頭を返す(その行の値は追加しない)
+// template<typename Parse, typename ... Ts>
+// char const* parse_rows_with(Parse parse, char const* first, char const* last, char delim, vector<Ts>& ... cols)
+// {
+//         char const* p=first;
+//         while(p!=last){
+//                 size_t const sizes[]={cols.size()...};
+//                 size_t column=0;
+//                 bool ok=true;
+//                 auto field=[&](auto& col){
+//                         typename remove_reference_t<decltype(col)>::value_type v;
+//                         auto [next, ec]=parse(p, last, v);
+//                         char const expected=++column==sizeof...(Ts) ? '\n' : delim;
+//                         ok=ec==errc() && next!=last && *next==expected;
+//                         if(ok){
+//                                 col.push_back(v);
+//                                 p=next+1;
+//                         }
+//                         return ok;
+//                 };
+//                 char const* row=p;
+//                 if(!(field(cols) && ...)){
+//                         column=0;
+//                         (cols.resize(sizes[column++]), ...);
+//                         return row;
+//                 }
+//         }
+//         return p;
+// }
+//
+// template<typename ... Ts>
+// char const* parse_rows(char const* first, char const* last, char delim, vector<Ts>& ... cols)
+// {
+//         return parse_rows_with([](char const* f, char const* l, auto& v){ return fast_from_chars(f, l, v); }, first, last, delim, cols...);
+// }
+//
+// // id(int32_t，6桁程度)，時刻(int64_t，ミリ秒で13桁)，価格(float，小数2桁)，測定値(double，17桁)の4列
+// void bench_parse_rows(size_t rows)
+// {
+//         mt19937_64 gen(1987);
+//         uniform_int_distribution<int32_t> id(-1'000'000, 1'000'000);
+//         uniform_int_distribution<int64_t> cents(1, 100'000);
+//         normal_distribution<double> measure(0.0, 1e3);
+//         string text;
+//         int64_t t=1'700'000'000'000;
+//         for(size_t i=0; i<rows; ++i){
+//                 char buf[128];
+//                 int n=snprintf(buf, sizeof(buf), "%d,%lld,%lld.%02lld,%.17g\n", id(gen), static_cast<long long>(t+=gen()%1000),
+//                                static_cast<long long>(cents(gen)/100), static_cast<long long>(cents(gen)%100), measure(gen));
+//                 text.append(buf, n);
+//         }
+//
+//         vector<int32_t> ids, ids2;
+//         vector<int64_t> times, times2;
+//         vector<float> prices, prices2;
+//         vector<double> values, values2;
+//         auto report=[&](char const* name, auto parse){
+//                 ids.clear();
+//                 times.clear();
+//                 prices.clear();
+//                 values.clear();
+//                 auto start=chrono::steady_clock::now();
+//                 parse();
+//                 chrono::duration<double> d=chrono::steady_clock::now()-start;
+//                 bool same=ids2.empty() || (ids==ids2 && times==times2 && prices==prices2 && values==values2);
+//                 cout << name << text.size()/d.count()/(1<<20) << " MB/s, " << d.count()*1e9/(4*rows) << " ns/field"
+//                      << (same ? "" : " (mismatch)") << endl;
+//         };
+//
+//         char const* first=text.data();
+//         char const* last=first+text.size();
+//         report("from_chars      ", [&]{
+//                 parse_rows_with([](char const* f, char const* l, auto& v){ return from_chars(f, l, v); }, first, last, ',', ids, times, prices, values);
+//         });
+//         ids2=ids;
+//         times2=times;
+//         prices2=prices;
+//         values2=values;
+//         report("fast_from_chars ", [&]{ parse_rows(first, last, ',', ids, times, prices, values); });
+//         report("strtol/strtod   ", [&]{
+//                 char* p=const_cast<char*>(first);
+//                 while(p!=last){
+//                         ids.push_back(static_cast<int32_t>(strtol(p, &p, 10)));
+//                         times.push_back(strtoll(p+1, &p, 10));
+//                         prices.push_back(strtof(p+1, &p));
+//                         values.push_back(strtod(p+1, &p));
+//                         ++p;
+//                 }
+//         });
+//         report("istringstream   ", [&]{
+//                 istringstream iss(text);
+//                 int32_t m;
+//                 int64_t s;
+//                 float f;
+//                 double d;
+//                 char comma;
+//                 while(iss >> m >> comma >> s >> comma >> f >> comma >> d){
+//                         ids.push_back(m);
+//                         times.push_back(s);
+//                         prices.push_back(f);
+//                         values.push_back(d);
+//                 }
+//         });
+// }
 
 
 /**
- * (i/o)fstream の使い方を確認したい
+ * 書き出すテキストをブロックごとに圧縮して並列に書き込みたい
+ * [fstream],[alg.copy]
  */
-// string str;
-// ifstream ifs("abc.txt");
-// ofstream ofs("def.txt");
+// // sample.txtのような繰り返しの多いテキストをそのまま書くと，ディスクの帯域で律速される
+// // LZ77系(LZ4に近い形式)でブロックごとに独立に圧縮する
+// // ・入力を1MiBのブロックに分け，各ブロックは前のブロックを参照しないので並列に圧縮・展開できる
+// // ・各ブロックにはヘッダ(圧縮後の大きさ，元の大きさ，元のデータのハッシュ値)を付ける
+// //   圧縮しても小さくならないブロックはそのまま格納する
+// // ・圧縮はsteal_poolで並列に行い，書き込みはブロックの順に行う
+// //   書き込む側は，溜めたブロックを圧縮に回したらすぐに次のブロックを溜め始める
+// // ・展開は1ブロックずつ行うので，読む側はファイル全体をメモリに置かなくてよい
+// // 圧縮形式: [トークン(上位4ビット:リテラル長，下位4ビット:一致長-4)][リテラル長の続き][リテラル][オフセット2バイト][一致長の続き]の繰り返し
+// //           長さが15以上の場合は255未満のバイトが来るまで足していく，ブロックの最後はリテラルだけで終わる
+// // レベル(1〜9)は一致を探す時にハッシュチェーンを辿る回数(2^(level-1))で，1ならハッシュ表の1候補だけを見る
+// namespace lz{
+//         constexpr size_t min_match=4;
+//         constexpr size_t max_offset=65535;
+//         constexpr int hash_bits=16;
+//
+//         uint32_t read32(char const* p)
+//         {
+//                 uint32_t v;
+//                 memcpy(&v, p, 4);
+//                 return v;
+//         }
 //
-// while(!getline(ifs, str).eof()){
-//         cout << str << endl;
-//         ofs << str << endl;
+//         uint32_t hash4(char const* p)
+//         {
+//                 return (read32(p)*2654435761u)>>(32-hash_bits);
+//         }
+//
+//         void put_length(string& out, size_t len)
+//         {
+//                 for(; len>=255; len-=255){
+//                         out+='\xff';
+//                 }
+//                 out+=static_cast<char>(len);
+//         }
+//
+//         void put_sequence(string& out, char const* lit, size_t lit_len, size_t offset, size_t match_len)
+//         {
+//                 size_t m=match_len ? match_len-min_match : 0;
+//                 out+=static_cast<char>(min<size_t>(lit_len, 15)<<4|min<size_t>(m, 15));
+//                 if(lit_len>=15){
+//                         put_length(out, lit_len-15);
+//                 }
+//                 out.append(lit, lit_len);
+//                 if(match_len){
+//                         out+=static_cast<char>(offset&0xff);
+//                         out+=static_cast<char>(offset>>8);
+//                         if(m>=15){
+//                                 put_length(out, m-15);
+//                         }
+//                 }
+//         }
+//
+//         void compress(string_view in, string& out, int level)
+//         {
+//                 char const* const src=in.data();
+//                 size_t const n=in.size();
+//                 int const depth=1<<(level-1);
+//                 vector<int32_t> head(size_t{1}<<hash_bits, -1);
+//                 vector<int32_t> chain(depth>1 ? n : 0);
+//                 auto insert=[&](size_t i){
+//                         uint32_t h=hash4(src+i);
+//                         if(depth>1){
+//                                 chain[i]=head[h];
+//                         }
+//                         head[h]=static_cast<int32_t>(i);
+//                 };
+//
+//                 size_t anchor=0, i=0;
+//                 while(n>=min_match && i<=n-min_match){
+//                         size_t best_len=0, best_off=0;
+//                         int32_t cand=head[hash4(src+i)];
+//                         for(int d=0; d<depth && cand>=0 && i-cand<=max_offset; ++d){
+//                                 if(read32(src+cand)==read32(src+i)){
+//                                         size_t len=min_match;
+//                                         while(i+len<n && src[cand+len]==src[i+len]){
+//                                                 ++len;
+//                                         }
+//                                         if(len>best_len){
+//                                                 best_len=len;
+//                                                 best_off=i-cand;
+//                                         }
+//                                 }
+//                                 if(depth==1){
+//                                         break;
+//                                 }
+//                                 cand=chain[cand];
+//                         }
+//                         insert(i);
+//                         if(!best_len){
+//                                 ++i;
+//                                 continue;
+//                         }
+//                         put_sequence(out, src+anchor, i-anchor, best_off, best_len);
+//                         size_t end=i+best_len;
+//                         // 一致した範囲も後の探索の候補にする(レベル1では速度を優先して飛ばす)
+//                         for(++i; depth>1 && i<end && i<=n-min_match; ++i){
+//                                 insert(i);
+//                         }
+//                         i=anchor=end;
+//                 }
+//                 put_sequence(out, src+anchor, n-anchor, 0, 0);
+//         }
+//
+//         // 壊れた入力でも範囲外を読み書きしない，raw_sizeと一致しなければfalse
+//         bool decompress(string_view in, char* dst, size_t raw_size)
+//         {
+//                 char const* p=in.data();
+//                 char const* const end=p+in.size();
+//                 size_t o=0;
+//                 auto get_length=[&](size_t len){
+//                         if(len==15){
+//                                 unsigned char c;
+//                                 do{
+//                                         if(p==end){
+//                                                 return ~size_t{0};
+//                                         }
+//                                         c=static_cast<unsigned char>(*p++);
+//                                         len+=c;
+//                                 }while(c==255);
+//                         }
+//                         return len;
+//                 };
+//                 while(p!=end){
+//                         auto token=static_cast<unsigned char>(*p++);
+//                         size_t lit=get_length(token>>4);
+//                         if(lit>static_cast<size_t>(end-p) || lit>raw_size-o){
+//                                 return false;
+//                         }
+//                         memcpy(dst+o, p, lit);
+//                         p+=lit;
+//                         o+=lit;
+//                         if(p==end){
+//                                 break; // 最後のリテラル
+//                         }
+//                         if(end-p<2){
+//                                 return false;
+//                         }
+//                         size_t offset=static_cast<unsigned char>(p[0])|static_cast<unsigned char>(p[1])<<8;
+//                         p+=2;
+//                         size_t len=get_length(token&15);
+//                         if(len==~size_t{0} || offset==0 || offset>o || len+min_match>raw_size-o){
+//                                 return false;
+//                         }
+//                         len+=min_match;
+//                         char* d=dst+o;
+//                         char const* s=d-offset;
+//                         for(size_t k=0; k<len; k+=offset){ // 重なっている場合は周期(offset)ずつコピーする
+//                                 memcpy(d+k, s+k, min(offset, len-k));
+//                         }
+//                         o+=len;
+//                 }
+//                 return o==raw_size;
+//         }
+//
+//         // ブロックの検査用のハッシュ値，fnv1aは1バイトずつなので8バイトずつ混ぜる
+//         uint64_t checksum(char const* p, size_t n)
+//         {
+//                 uint64_t h=n*0x9e3779b97f4a7c15;
+//                 size_t i=0;
+//                 for(; i+8<=n; i+=8){
+//                         uint64_t w;
+//                         memcpy(&w, p+i, 8);
+//                         h=(h^w)*0xff51afd7ed558ccd;
+//                         h^=h>>29;
+//                 }
+//                 return h^fnv1a(p+i, n-i);
+//         }
+//
+//         struct block_header{
+//                 uint32_t stored_size; // 最上位ビットが立っていれば圧縮せずに格納
+//                 uint32_t raw_size;
+//                 uint64_t checksum;
+//         };
+//
+//         constexpr uint32_t raw_flag=0x80000000;
+//         char const magic[4]={'L', 'Z', 'B', '\x01'};
+//
+//         // ヘッダ付きの1ブロック
+//         string encode_block(string_view raw, int level)
+//         {
+//                 string out(sizeof(block_header), '\0');
+//                 compress(raw, out, level);
+//                 block_header h{static_cast<uint32_t>(out.size()-sizeof(block_header)), static_cast<uint32_t>(raw.size()), checksum(raw.data(), raw.size())};
+//                 if(h.stored_size>=raw.size()){
+//                         out.resize(sizeof(block_header));
+//                         out+=raw;
+//                         h.stored_size=static_cast<uint32_t>(raw.size())|raw_flag;
+//                 }
+//                 memcpy(out.data(), &h, sizeof(h));
+//                 return out;
+//         }
+//
+//         class writer{
+//                 unique_ptr<FILE, int (*)(FILE*)> m_fp;
+//                 steal_pool& m_pool;
+//                 int m_level;
+//                 size_t m_block_size;
+//                 vector<string> m_pending; // 圧縮待ちのブロック
+//                 string m_cur;
+//                 deque<shared_future<void>> m_batches; // 圧縮中か書き込み中のバッチ，古い順
+//                 atomic<bool> m_error{false};
+//
+//                 // 溜まったブロックを別のスレッドに渡して並列に圧縮し，前のバッチを書き終えてから順に書く
+//                 // 呼び出した側はすぐに次のバッチを溜め始められ，あるバッチの圧縮と前のバッチの書き込みが重なる(ダブルバッファ)
+//                 // 手元に置くのは圧縮中と書き込み中の2バッチまで
+//                 void flush()
+//                 {
+//                         if(m_pending.empty()){
+//                                 return;
+//                         }
+//                         if(m_batches.size()==2){
+//                                 m_batches.front().get();
+//                                 m_batches.pop_front();
+//                         }
+//                         shared_future<void> prev=m_batches.empty() ? shared_future<void>() : m_batches.back();
+//                         m_batches.push_back(async(launch::async, [this, batch=move(m_pending), prev]{
+//                                 vector<string> encoded(batch.size());
+//                                 m_pool.parallel_for(batch.size(), [&](size_t i){
+//                                         trace::scope s("lz compress");
+//                                         encoded[i]=encode_block(batch[i], m_level);
+//                                 });
+//                                 if(prev.valid()){
+//                                         prev.wait();
+//                                 }
+//                                 trace::scope s("lz write");
+//                                 for(auto const& e: encoded){
+//                                         if(!m_error && fwrite(e.data(), 1, e.size(), m_fp.get())!=e.size()){
+//                                                 m_error=true;
+//                                         }
+//                                 }
+//                         }).share());
+//                         m_pending.clear();
+//                 }
+//         public:
+//                 // levelは1〜9に丸める，block_sizeは0より大きくraw_flag未満でなければ開かずにerror()にする
+//                 writer(char const* path, steal_pool& pool, int level=1, size_t block_size=1<<20)
+//                         :m_fp(block_size>0 && block_size<raw_flag ? fopen(path, "wb") : nullptr, &fclose), m_pool{pool}, m_level{clamp(level, 1, 9)}, m_block_size{block_size}
+//                 {
+//                         auto bs=static_cast<uint32_t>(block_size);
+//                         m_error=!m_fp || fwrite(magic, 1, 4, m_fp.get())!=4 || fwrite(&bs, sizeof(bs), 1, m_fp.get())!=1;
+//                 }
+//
+//                 writer(writer const&)=delete;
+//                 writer& operator=(writer const&)=delete;
+//
+//                 ~writer()
+//                 {
+//                         close();
+//                 }
+//
+//                 // 開けなかったか，書き込みに失敗した，書いたデータは読めない
+//                 bool error() const
+//                 {
+//                         return m_error;
+//                 }
+//
+//                 void write(string_view s)
+//                 {
+//                         if(m_error){
+//                                 return;
+//                         }
+//                         while(!s.empty()){
+//                                 size_t n=min(s.size(), m_block_size-m_cur.size());
+//                                 m_cur.append(s.data(), n);
+//                                 s.remove_prefix(n);
+//                                 if(m_cur.size()==m_block_size){
+//                                         m_pending.push_back(move(m_cur));
+//                                         m_cur.clear();
+//                                         if(m_pending.size()==2*m_pool.size()){
+//                                                 flush();
+//                                         }
+//                                 }
+//                         }
+//                 }
+//
+//                 void close()
+//                 {
+//                         if(!m_fp){
+//                                 return;
+//                         }
+//                         if(!m_cur.empty()){
+//                                 m_pending.push_back(move(m_cur));
+//                                 m_cur.clear();
+//                         }
+//                         flush();
+//                         for(auto& b: m_batches){
+//                                 b.wait();
+//                         }
+//                         m_batches.clear();
+//                         uint32_t eof=0;
+//                         m_error=m_error || fwrite(&eof, sizeof(eof), 1, m_fp.get())!=1;
+//                         m_error=fclose(m_fp.release())!=0 || m_error;
+//                 }
+//         };
+//
+//         class reader{
+//                 unique_ptr<FILE, int (*)(FILE*)> m_fp;
+//                 size_t m_block_size=0;
+//                 string m_in;
+//                 bool m_error=false;
+//                 bool m_end=false; // 終わりの印(0)を読んだ
+//         public:
+//                 explicit reader(char const* path):m_fp(fopen(path, "rb"), &fclose)
+//                 {
+//                         char mg[4];
+//                         uint32_t bs;
+//                         m_error=!m_fp || fread(mg, 1, 4, m_fp.get())!=4 || memcmp(mg, magic, 4)!=0 || fread(&bs, sizeof(bs), 1, m_fp.get())!=1
+//                                 || bs==0 || bs>=raw_flag;
+//                         m_block_size=m_error ? 0 : bs;
+//                 }
+//
+//                 bool error() const
+//                 {
+//                         return m_error;
+//                 }
+//
+//                 // 次のブロックを展開してoutに入れる，終わりか壊れていればfalse
+//                 // 終わりの印を読む前にファイルが終わった(ブロックの境界で切れた)場合も壊れているとする
+//                 bool next(string& out)
+//                 {
+//                         trace::scope s("lz decompress");
+//                         if(m_error || m_end){
+//                                 return false;
+//                         }
+//                         block_header h;
+//                         if(fread(&h.stored_size, sizeof(h.stored_size), 1, m_fp.get())!=1){
+//                                 m_error=true;
+//                                 return false;
+//                         }
+//                         if(h.stored_size==0){
+//                                 m_end=true;
+//                                 return false;
+//                         }
+//                         size_t stored=h.stored_size&~raw_flag;
+//                         m_error=fread(&h.raw_size, sizeof(h)-sizeof(h.stored_size), 1, m_fp.get())!=1
+//                                 || h.raw_size>m_block_size || stored>m_block_size; // 圧縮して大きくなるブロックはそのまま格納している
+//                         if(m_error){
+//                                 return false;
+//                         }
+//                         m_in.resize(stored);
+//                         out.resize(h.raw_size);
+//                         m_error=fread(m_in.data(), 1, stored, m_fp.get())!=stored;
+//                         if(!m_error && (h.stored_size&raw_flag)){
+//                                 m_error=stored!=h.raw_size;
+//                                 out=m_in;
+//                         }else if(!m_error){
+//                                 m_error=!decompress(m_in, out.data(), h.raw_size);
+//                         }
+//                         m_error=m_error || checksum(out.data(), out.size())!=h.checksum;
+//                         return !m_error;
+//                 }
+//         };
+// }
+//
+// void bench_compress(size_t mega_bytes)
+// {
+//         ifstream ifs("sample.txt");
+//         string sample((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+//         string text;
+//         for(size_t i=0; text.size()<mega_bytes<<20; ++i){
+//                 text+=sample;
+//                 text+=to_string(i*2654435761u%1'000'000);
+//                 text+='\n';
+//         }
+//
+//         steal_pool pool;
+//         for(int level: {1, 3, 6, 9}){
+//                 auto t0=chrono::steady_clock::now();
+//                 {
+//                         lz::writer w("def.txt.lzb", pool, level);
+//                         for(size_t pos=0; pos<text.size(); pos+=4096){
+//                                 w.write(string_view(text).substr(pos, 4096));
+//                         }
+//                         w.close();
+//                         if(w.error()){
+//                                 cout << "cannot write def.txt.lzb" << endl;
+//                                 return;
+//                         }
+//                 }
+//                 auto t1=chrono::steady_clock::now();
+//
+//                 lz::reader r("def.txt.lzb");
+//                 string block;
+//                 size_t pos=0;
+//                 bool same=true;
+//                 while(r.next(block)){
+//                         same&=text.compare(pos, block.size(), block)==0;
+//                         pos+=block.size();
+//                 }
+//                 auto t2=chrono::steady_clock::now();
+//
+//                 auto size=static_cast<double>(ifstream("def.txt.lzb", ios::ate).tellg());
+//                 auto mbps=[&](auto d){ return text.size()/chrono::duration<double>(d).count()/(1<<20); };
+//                 cout << "level " << level << ": ratio " << text.size()/size << ", compress " << mbps(t1-t0) << " MB/s, decompress "
+//                      << mbps(t2-t1) << " MB/s" << (same && pos==text.size() && !r.error() ? "" : " (mismatch)") << endl;
+//         }
 // }
 
 
@@ -1327,6 +7708,200 @@ using namespace std;
 // X const& x8=2;
 
 
+/**
+ * インラインバッファの大きい文字列クラスを作りたい
+ * [class.union],[class.copy.ctor],[string.view]
+ */
+// // libstdc++のstd::stringは，15バイトまでの文字列をオブジェクト内に格納する(SSO，Small String Optimization)
+// // 16〜30バイトの単語が多いデータでは，ほぼ全ての文字列がヒープに確保されてしまう
+// // インラインバッファの大きさNをテンプレート引数で指定できるようにする
+// // ・長さがN以下ならバッファに格納し，それを超える場合だけヒープに確保する
+// //   従って長さを見ればどちらに格納されているかがわかり，別のフラグは要らない
+// // ・バッファとポインタはトリビアルな共用体にまとめ，ムーブは共用体ごとmemcpyするだけにする
+// //   どちらに格納されていても同じ処理になるので，ムーブに分岐が無い
+// // ・変更はコピーして入れ替える(copy-and-swap)ことで行い，容量は持たない
+// template<size_t N>
+// class sso_string{
+//         union storage{
+//                 char buf[N+1];
+//                 char* ptr;
+//         };
+//         static_assert(is_trivially_copyable_v<storage>);
+//         static_assert(N>=sizeof(char*));
+//
+//         storage m_u;
+//         size_t m_size;
+//
+//         bool is_heap() const noexcept
+//         {
+//                 return m_size>N;
+//         }
+//
+//         void assign(char const* s, size_t n)
+//         {
+//                 char* p=m_u.buf;
+//                 if(n>N){
+//                         p=new char[n+1];
+//                         m_u.ptr=p;
+//                 }
+//                 memcpy(p, s, n);
+//                 p[n]='\0';
+//                 m_size=n;
+//         }
+// public:
+//         sso_string() noexcept:m_size{0}
+//         {
+//                 m_u.buf[0]='\0';
+//         }
+//
+//         sso_string(string_view s)
+//         {
+//                 assign(s.data(), s.size());
+//         }
+//
+//         sso_string(char const* s):sso_string(string_view(s)){}
+//
+//         // バッファに収まる場合は，バッファ全体を固定長でコピーする
+//         sso_string(sso_string const& other):m_u{other.m_u}, m_size{other.m_size}
+//         {
+//                 if(is_heap()){
+//                         assign(other.m_u.ptr, other.m_size);
+//                 }
+//         }
+//
+//         sso_string(sso_string&& other) noexcept:m_u{other.m_u}, m_size{other.m_size}
+//         {
+//                 other.m_size=0;
+//                 other.m_u.buf[0]='\0';
+//         }
+//
+//         sso_string& operator=(sso_string other) noexcept
+//         {
+//                 swap(other);
+//                 return *this;
+//         }
+//
+//         ~sso_string()
+//         {
+//                 if(is_heap()){
+//                         delete[] m_u.ptr;
+//                 }
+//         }
+//
+//         void swap(sso_string& other) noexcept
+//         {
+//                 std::swap(m_u, other.m_u);
+//                 std::swap(m_size, other.m_size);
+//         }
+//
+//         char const* data() const noexcept
+//         {
+//                 return is_heap() ? m_u.ptr : m_u.buf;
+//         }
+//
+//         char const* c_str() const noexcept { return data(); }
+//         size_t size() const noexcept { return m_size; }
+//         bool empty() const noexcept { return m_size==0; }
+//         char const* begin() const noexcept { return data(); }
+//         char const* end() const noexcept { return data()+m_size; }
+//         char operator[](size_t i) const noexcept { return data()[i]; }
+//
+//         operator string_view() const noexcept
+//         {
+//                 return {data(), m_size};
+//         }
+//
+//         friend bool operator==(sso_string const& a, sso_string const& b) noexcept
+//         {
+//                 return string_view(a)==string_view(b);
+//         }
+//
+//         friend bool operator<(sso_string const& a, sso_string const& b) noexcept
+//         {
+//                 return string_view(a)<string_view(b);
+//         }
+// };
+//
+// namespace std{
+//         template<size_t N>
+//         struct hash<sso_string<N>>{
+//                 size_t operator()(sso_string<N> const& s) const noexcept
+//                 {
+//                         return hash<string_view>{}(s);
+//                 }
+//         };
+// }
+//
+// static_assert(sizeof(sso_string<23>)==sizeof(string)); // 同じ大きさでインラインに23バイトまで入る
+//
+// // 実際のデータとして，このファイル自身を空白で区切った単語を使う
+// template<typename S>
+// void bench_string(char const* name, vector<string> const& tokens, size_t inline_size)
+// {
+//         size_t const n=tokens.size();
+//         size_t fits=count_if(tokens.begin(), tokens.end(), [&](string const& t){ return t.size()<=inline_size; });
+//
+//         trace::scope scope(name);
+//         vector<S> a, b, c;
+//         size_t h=0;
+//
+//         auto t0=chrono::steady_clock::now();
+//         {
+//                 trace::scope phase("construct");
+//                 a.reserve(n);
+//                 for(auto const& t: tokens){
+//                         a.emplace_back(string_view(t));
+//                 }
+//         }
+//
+//         auto t1=chrono::steady_clock::now();
+//         {
+//                 trace::scope phase("copy");
+//                 b=a;
+//         }
+//
+//         auto t2=chrono::steady_clock::now();
+//         {
+//                 trace::scope phase("move");
+//                 c.reserve(n);
+//                 for(auto& s: b){
+//                         c.push_back(move(s));
+//                 }
+//         }
+//
+//         auto t3=chrono::steady_clock::now();
+//         {
+//                 trace::scope phase("hash");
+//                 for(auto const& s: c){
+//                         h+=hash<S>{}(s);
+//                 }
+//         }
+//
+//         auto t4=chrono::steady_clock::now();
+//         auto per=[n](auto d){ return chrono::duration<double, nano>(d).count()/n; };
+//         cout << name << ": construct " << per(t1-t0) << " ns, copy " << per(t2-t1) << " ns, move " << per(t3-t2)
+//              << " ns, hash " << per(t4-t3) << " ns, inline " << 100.0*fits/n << "% (" << h << ")" << endl;
+// }
+//
+// void bench_string()
+// {
+//         vector<string> tokens;
+//         ifstream ifs("study.cpp");
+//         string tok;
+//         while(ifs >> tok){
+//                 tokens.push_back(tok);
+//         }
+//         vector<string> const once=tokens;
+//         for(int i=0; i<15; ++i){
+//                 tokens.insert(tokens.end(), once.begin(), once.end());
+//         }
+//
+//         bench_string<string>("std::string     ", tokens, 15);
+//         bench_string<sso_string<23>>("sso_string<23>  ", tokens, 23);
+//         bench_string<sso_string<31>>("sso_string<31>  ", tokens, 31);
+// }
+
+
 /**
  * ポインタのcv変換の仕様を確認したい
  */
@@ -1343,3 +7918,133 @@ using namespace std;
 // char *p;
 // char *const* q=&p; // これは問題ない
 
+
+/**
+ * 変更されない文字列を char const* のハンドルとして共有したい
+ * [conv.qual],[thread.sharedmutex.class]
+ */
+// // 上の例のように char const* は指す先を変更しないことを型で保証できる
+// // 同じ内容の文字列を1箇所にだけ格納し(intern)，その場所を指す char const* を配ると，
+// // ・文字列の比較がポインタの比較で済む
+// // ・"hoge"，"fuga"のように何度も現れる単語のメモリが1つ分で済む
+// // 格納先はブロック単位で確保して追記するだけ(アリーナ)にすると，一度配ったポインタが無効になることはない
+// // 複数スレッドから使えるように，ハッシュ値で表を分割(シャード)して，各シャードを shared_mutex で保護する
+// // 既出の文字列を探すだけなら共有ロックなので，読み取り同士は並行に動く
+// // ただしロックフリーではない，共有ロックでもロックの語へのアトミックな書き込みは毎回起きるので，
+// // 同じシャードを多くのスレッドが読むとそのキャッシュラインが行き来する
+// // ロックフリーな表にしなかったのは，IDから文字列への表(vector)を伸ばす間に読まれても安全にするため
+// // 隣のシャードのロックと同じキャッシュラインに乗らないように，シャードは alignas(64) で1つずつキャッシュラインに揃える
+// // 32ビットのIDも配る，下位ビットがシャード番号，上位ビットがシャード内の通し番号である
+// class intern_pool{
+//         static constexpr unsigned shard_bits=4;
+//         static constexpr size_t block_size=64*1024;
+//
+//         struct alignas(64) shard{
+//                 mutable shared_mutex mtx;
+//                 unordered_map<string_view, uint32_t> ids; // キーはアリーナ内の文字列を指す
+//                 vector<char const*> strs; // シャード内の通し番号→文字列
+//                 vector<unique_ptr<char[]>> blocks;
+//                 char* cur=nullptr;
+//                 size_t left=0;
+//
+//                 // [長さ(uint32_t)][文字列]['\0'] の形で格納し，文字列の先頭を返す
+//                 // 長さはmemcpyで読み書きするので，アライメントは揃えなくて良い
+//                 char const* store(string_view s)
+//                 {
+//                         size_t need=sizeof(uint32_t)+s.size()+1;
+//                         if(need>left){
+//                                 size_t n=max(block_size, need);
+//                                 blocks.push_back(make_unique<char[]>(n));
+//                                 cur=blocks.back().get();
+//                                 left=n;
+//                         }
+//                         auto len=static_cast<uint32_t>(s.size());
+//                         memcpy(cur, &len, sizeof(len));
+//                         char* p=cur+sizeof(len);
+//                         memcpy(p, s.data(), s.size());
+//                         p[s.size()]='\0';
+//                         cur+=need;
+//                         left-=need;
+//                         return p;
+//                 }
+//         };
+//
+//         shard m_shards[1<<shard_bits];
+// public:
+//         struct handle{
+//                 char const* str;
+//                 uint32_t id;
+//         };
+//
+//         handle intern(string_view s)
+//         {
+//                 size_t h=hash<string_view>{}(s);
+//                 uint32_t si=h&((1<<shard_bits)-1);
+//                 shard& sh=m_shards[si];
+//                 {
+//                         shared_lock<shared_mutex> lock(sh.mtx);
+//                         auto it=sh.ids.find(s);
+//                         if(it!=sh.ids.end()){
+//                                 return {it->first.data(), it->second};
+//                         }
+//                 }
+//
+//                 // 共有ロックを外してから排他ロックを取るまでに，他のスレッドが追加しているかもしれない
+//                 unique_lock<shared_mutex> lock(sh.mtx);
+//                 auto it=sh.ids.find(s);
+//                 if(it!=sh.ids.end()){
+//                         return {it->first.data(), it->second};
+//                 }
+//                 char const* p=sh.store(s);
+//                 auto id=static_cast<uint32_t>(sh.strs.size()<<shard_bits|si);
+//                 sh.strs.push_back(p);
+//                 sh.ids.emplace(string_view(p, s.size()), id);
+//                 return {p, id};
+//         }
+//
+//         char const* str(uint32_t id) const
+//         {
+//                 shard const& sh=m_shards[id&((1<<shard_bits)-1)];
+//                 shared_lock<shared_mutex> lock(sh.mtx);
+//                 return sh.strs[id>>shard_bits];
+//         }
+//
+//         // 長さは文字列の直前に格納されている
+//         static string_view view(char const* p)
+//         {
+//                 uint32_t len;
+//                 memcpy(&len, p-sizeof(len), sizeof(len));
+//                 return {p, len};
+//         }
+// };
+//
+// void demo_intern()
+// {
+//         intern_pool pool;
+//         char const* words[]={"hoge", "fuga", "foo", "bar", "aaaaaaaaaaaaaa"};
+//
+//         vector<thread> ts;
+//         vector<vector<char const*>> seen(4);
+//         for(size_t t=0; t<seen.size(); ++t){
+//                 ts.emplace_back([&, t]{
+//                         for(int i=0; i<1'000'000; ++i){
+//                                 seen[t].push_back(pool.intern(words[(i+t)%5]).str);
+//                         }
+//                 });
+//         }
+//         for(auto& t: ts){
+//                 t.join();
+//         }
+//
+//         // 同じ単語は，どのスレッドで追加しても同じポインタになる
+//         bool same=true;
+//         for(size_t t=1; t<seen.size(); ++t){
+//                 for(size_t i=0; i<seen[t].size(); ++i){
+//                         same&=seen[t][i]==seen[0][(i+t)%seen[0].size()];
+//                 }
+//         }
+//
+//         auto h=pool.intern("hoge");
+//         cout << boolalpha << same << ' ' << h.str << ' ' << pool.str(h.id) << ' ' << intern_pool::view(h.str).size() << endl;
+// }
+